@@ -0,0 +1,50 @@
+#pragma once
+
+//
+// BENCH.hpp
+//
+// layouts the helpers shared by the benchmarks
+//
+
+#include "../src/snippets.h"
+
+#include <functional>
+
+namespace bench {
+    extern uint32 runs; //> how often each measurement is repeated. The fastest run is reported
+
+    /**
+     * @brief run fn runs times
+     *
+     * @return the time of the fastest run in seconds
+     */
+    double best(const std::function<void()>& fn);
+
+    /**
+     * @brief print a result line with the time and, if bytes is set, the throughput
+     */
+    void report(const String& name, double seconds, uint64 bytes = 0);
+
+    // benchmarks, each prints its own results
+
+    /**
+     * @brief lexer throughput on a generated module
+     */
+    void lexer();
+
+    /**
+     * @brief lexer throughput on comment-heavy and identifier-heavy input with the scanner this process uses
+     */
+    void scan();
+
+    /**
+     * @brief lexer scaling from one thread to one per hardware thread on a large file
+     */
+    void threads();
+
+    /**
+     * @brief expression parse times on long chains, deep nesting and many short expressions. Chains are kept short
+     * enough for the recursive walks over the tree in a debug build
+     */
+    void expr();
+} // namespace bench
@@ -0,0 +1,109 @@
+//
+// LEXER.cpp
+//
+// benchmarks for the lexer
+//
+
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/lexer/scan.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief generate a module of about size bytes that looks like the code our generators emit
+ */
+static String generatedModule(uint64 size) {
+    String text = "import std::io;\n\n";
+    for (uint64 i = 0; text.size() < size; i++) {
+        String n = std::to_string(i);
+        text += "// function " + n + "\n"
+                "int32 compute_" + n + "(int32 a, int32 b) {\n"
+                "    /* mixes the arguments */\n"
+                "    int32 x_" + n + " = a * 3 + b - 0x1F;\n"
+                "    float64 f = 1.5e3 + .5;\n"
+                "    if (x_" + n + " > 10 && b != 0) {\n"
+                "        x_" + n + " = x_" + n + " % 7;\n"
+                "        std::io::println(\"value: \");\n"
+                "    }\n"
+                "    return x_" + n + " + 'c';\n"
+                "}\n\n";
+    }
+    return text;
+}
+
+/**
+ * @brief generate about size bytes that are mostly comments
+ */
+static String commentHeavy(uint64 size) {
+    String text = "";
+    for (uint64 i = 0; text.size() < size; i++) {
+        text += "/* this block explains what the next declaration does, in far more words than it needs.\n"
+                "   it goes on for a second line, just like the license headers and docs we generate */\n"
+                "// a line comment follows, which is skipped up to its end in one go\n"
+                "int32 value_" + std::to_string(i) + " = 1; // and a trailing one\n";
+    }
+    return text;
+}
+
+/**
+ * @brief generate about size bytes that are mostly long identifiers
+ */
+static String identHeavy(uint64 size) {
+    String text = "";
+    for (uint64 i = 0; text.size() < size; i++) {
+        String n = std::to_string(i);
+        text += "generated_identifier_alpha_" + n + " generated_identifier_beta_" + n +
+                " generated_identifier_gamma_" + n + " generated_identifier_delta_" + n + ";\n";
+    }
+    return text;
+}
+
+/**
+ * @brief report the time tokenize takes on text
+ */
+static void lex(const String& name, const String& text) {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held        = &diagnostics;
+    lexer::Source& src = lexer::sources.add(name + ".cst", text);
+    uint64 tokens      = 0;
+
+    double seconds = bench::best([&]() {
+        tokens = lexer::tokenize(src).size();
+        diagnostics.clear();
+    });
+    bench::report(name + " (" + std::to_string(text.size() / 1000) + " KB, " + std::to_string(tokens / 1000) +
+                      "k tokens)",
+                  seconds,
+                  text.size());
+    lexer::held = nullptr;
+}
+
+void bench::lexer() {
+    lexer::threads = 1;
+    lex("generated module", generatedModule(1 << 20));
+}
+
+void bench::scan() {
+    // the scanner is chosen once per process, run this with CSTC_SCAN=scalar|sse2|avx2 to compare them
+    std::printf("  scanner: %s\n", lexer::scan::scanner().name);
+    lexer::threads = 1;
+    lex("comment-heavy", commentHeavy(3 << 20));
+    lex("ident-heavy", identHeavy(5 << 20));
+    lex("generated module", generatedModule(1 << 20));
+}
+
+void bench::threads() {
+    uint32 cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("  hardware threads: %u\n", cores);
+    String text = generatedModule(20 << 20);
+    for (uint32 n = 1; n <= std::max(4u, cores); n *= 2) {
+        lexer::threads = n;
+        lex(std::to_string(n) + (n == 1 ? " thread" : " threads"), text);
+    }
+    lexer::threads = 1;
+}
@@ -0,0 +1,69 @@
+//
+// MAIN.cpp
+//
+// runs the benchmarks
+//
+
+#include "bench.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+uint32 bench::runs = 5;
+
+static const std::map<String, void (*)()> BENCHMARKS = {
+    {"expr",    bench::expr   },
+    {"lexer",   bench::lexer  },
+    {"scan",    bench::scan   },
+    {"threads", bench::threads},
+};
+
+double bench::best(const std::function<void()>& fn) {
+    double fastest = 0;
+    for (uint32 i = 0; i < runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < fastest) { fastest = seconds; }
+    }
+    return fastest;
+}
+
+void bench::report(const String& name, double seconds, uint64 bytes) {
+    std::printf("  %-44s %10.2f ms", name.c_str(), seconds * 1000);
+    if (bytes != 0) { std::printf("  %8.1f MB/s", bytes / seconds / 1e6); }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+int32 main(int32 argc, const char** argv) {
+    std::vector<String> chosen = {};
+    for (int32 i = 1; i < argc; i++) {
+        String arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) {
+            bench::runs = std::max(1, std::atoi(argv[++i]));
+        } else if (BENCHMARKS.count(arg)) {
+            chosen.push_back(arg);
+        } else {
+            std::fprintf(stderr, "usage: %s [-r RUNS] [BENCHMARK...]\nbenchmarks:", argv[0]);
+            for (const auto& b : BENCHMARKS) { std::fprintf(stderr, " %s", b.first.c_str()); }
+            std::fprintf(stderr, "\n");
+            return 1;
+        }
+    }
+    if (chosen.empty()) {
+        for (const auto& b : BENCHMARKS) { chosen.push_back(b.first); }
+    }
+
+#ifdef DEBUG_ON
+    std::printf("note: this is a debug build, configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers\n");
+#endif
+    std::printf("best of %u runs\n", bench::runs);
+    for (const String& name : chosen) {
+        std::printf("%s:\n", name.c_str());
+        BENCHMARKS.at(name)();
+    }
+    return 0;
+}
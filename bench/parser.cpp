@@ -0,0 +1,62 @@
+//
+// PARSER.cpp
+//
+// benchmarks for the parser
+//
+
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/ast/base_math.hpp"
+#include "../src/parser/symboltable.hpp"
+#include "bench.hpp"
+
+#include <vector>
+
+static const char* OPERATORS[] = {" + ", " * ", " - ", " / ", " % ", " == ", " < ", " && ", " | ", " ^ "};
+
+static lexer::TokenStream tokensOf(const String& text) {
+    // the lexer needs something after the last token
+    return lexer::tokenize(lexer::sources.add("expr.cst", text + "\n"));
+}
+
+/**
+ * @brief report the time math::parse takes on all expressions
+ */
+static void parse(const String& name, const std::vector<String>& expressions) {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+    std::vector<lexer::TokenStream> all;
+    for (const String& e : expressions) { all.push_back(tokensOf(e)); }
+
+    symbol::Namespace sr("bench");
+    bench::report(name, bench::best([&]() {
+                      for (const lexer::TokenStream& tokens : all) { math::parse(tokens, 0, &sr); }
+                  }));
+    lexer::held = nullptr;
+}
+
+static String chain(uint64 terms) {
+    String text = "1";
+    for (uint64 i = 1; i < terms; i++) { text += " + " + std::to_string(i % 100); }
+    return text;
+}
+
+void bench::expr() {
+    // parsing a chain does not recurse per term, but typing, folding and freeing the tree do. In a debug
+    // build with an 8 MB stack, chains of about 15000 terms overflow it, so they are kept well below that
+    for (uint64 terms : {1000, 2000, 4000, 8000}) {
+        parse("chain of " + std::to_string(terms) + " terms", {chain(terms)});
+    }
+
+    parse("2000 nested parens", {String(2000, '(') + "1" + String(2000, ')')});
+
+    String mixed = "1";
+    for (uint64 i = 1; i < 4000; i++) {
+        mixed += OPERATORS[i % (sizeof(OPERATORS) / sizeof(OPERATORS[0]))] + std::to_string(i % 100);
+    }
+    parse("4000 mixed operators", {mixed});
+
+    std::vector<String> short_ones = {};
+    for (uint64 i = 0; i < 5000; i++) { short_ones.push_back("(1 + " + std::to_string(i % 100) + ") * 3 - 4"); }
+    parse("5000 short expressions", short_ones);
+}
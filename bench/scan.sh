@@ -0,0 +1,13 @@
+#!/bin/sh
+#
+# SCAN.sh
+#
+# runs the scan benchmark once with each scanner implementation
+# usage: bench/scan.sh [CSTC-BENCH] [-r RUNS]
+#
+
+BENCH=${1:-./bin/cstc-bench}
+[ $# -gt 0 ] && shift
+for scanner in scalar sse2 avx2; do
+    CSTC_SCAN=$scanner "$BENCH" "$@" scan || exit 1
+done
@@ -0,0 +1,291 @@
+//
+// CACHE.cpp
+//
+// implements the on-disk token cache
+//
+
+#include "cache.hpp"
+
+#include "../snippets.h"
+#include "errors.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
+#include "token.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define CSTC_HAS_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <iterator>
+#endif
+
+bool   lexer::cache::enabled   = true;          //> whether the cache is used at all
+String lexer::cache::directory = ".cstc-cache"; //> where cached tokens are stored
+
+namespace lexer::cache {
+    /**
+     * @brief the start of every cache entry. Everything in it has to match for the entry to be used
+     */
+    struct Header {
+            char   magic[8];    //> "CSTCTOK" and a zero
+            uint32 version;     //> cache::VERSION
+            int32  pretty_size; //> lexer::pretty_size, as it changes the warnings issued
+            uint64 text_size;   //> size of the text tokenized, which follows the header
+            uint64 text_hash;   //> hash of the text tokenized
+            uint64 data_hash;   //> hash of everything after the header, so damaged entries are not used
+    };
+
+    constexpr char MAGIC[8] = "CSTCTOK";
+
+    /**
+     * @brief append the raw bytes of a value to out
+     */
+    template <typename T>
+    void put(String& out, const T& value) {
+        out.append((const char*) &value, sizeof(T));
+    }
+
+    /**
+     * @brief append a String with its size to out
+     */
+    void putString(String& out, std::string_view s) {
+        put(out, (uint64) s.size());
+        out.append(s);
+    }
+
+    /**
+     * @brief read the raw bytes of a value from the start of in and advance it
+     *
+     * @return false if in is too short
+     */
+    template <typename T>
+    bool take(std::string_view& in, T& value) {
+        if (in.size() < sizeof(T)) return false;
+        std::memcpy((void*) &value, in.data(), sizeof(T));
+        in.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief read a String written by putString from the start of in and advance it
+     *
+     * @return false if in is too short
+     */
+    bool takeString(std::string_view& in, std::string_view& s) {
+        uint64 size;
+        if (!take(in, size) || in.size() < size) return false;
+        s = in.substr(0, size);
+        in.remove_prefix(size);
+        return true;
+    }
+
+    /**
+     * @brief get the file a cache entry for a text with the given hash is stored in
+     */
+    std::filesystem::path entry(uint64 text_hash) {
+        String key = "";
+        put(key, text_hash);
+        put(key, VERSION);
+        put(key, pretty_size);
+        char name[24];
+        std::snprintf(name, sizeof(name), "%016llx.tok", (unsigned long long) hash(key));
+        return std::filesystem::path(directory) / name;
+    }
+
+    /**
+     * @brief write a cache entry
+     */
+    void store(Source& source, uint64 text_hash, const TokenStream& tokens, const std::vector<Diagnostic>& diagnostics) {
+        String out = "";
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version     = VERSION;
+        header.pretty_size = pretty_size;
+        header.text_size   = source.text.size();
+        header.text_hash   = text_hash;
+        put(out, header); // data_hash is filled in once the rest is written
+
+        // the text itself is stored too, so an entry is never used for another text with the same hash
+        out.append(source.text);
+        tokens.serialize(out);
+
+        put(out, (uint64) diagnostics.size());
+        for (const Diagnostic& d : diagnostics) {
+            put(out, (uint8) d.kind);
+            putString(out, d.name);
+            putString(out, d.msg);
+            putString(out, d.appendix);
+            put(out, d.code);
+            put(out, (uint64) d.tokens.size());
+            for (const Token& t : d.tokens) {
+                put(out, t.type);
+                put(out, t.l);
+                put(out, t.c);
+                put(out, t.offset);
+                put(out, (uint8) (t.file == source.id));
+                putString(out, t.value);
+            }
+        }
+
+        header.data_hash = hash(std::string_view(out).substr(sizeof(Header)));
+        std::memcpy(out.data(), &header, sizeof(Header));
+
+        // write to a temporary file first, so other compiler runs never see half an entry
+        std::error_code       ec;
+        std::filesystem::path path = entry(text_hash);
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+#ifdef CSTC_HAS_MMAP
+        temp += ".tmp" + std::to_string(getpid());
+#else
+        temp += ".tmp";
+#endif
+        {
+            std::ofstream f(temp, std::ios::binary | std::ios::trunc);
+            if (!f.write(out.data(), out.size())) {
+                f.close();
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec) std::filesystem::remove(temp, ec);
+    }
+
+    /**
+     * @brief read a cache entry from data
+     *
+     * @return the tokens and diagnostics or nothing if data is not a valid entry for source
+     */
+    std::optional<std::pair<TokenStore, std::vector<Diagnostic>>> parse(std::string_view data, Source& source,
+                                                                       uint64 text_hash) {
+        Header header;
+        if (!take(data, header) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION || header.pretty_size != pretty_size ||
+            header.text_size != source.text.size() || header.text_hash != text_hash ||
+            header.data_hash != hash(data) || data.substr(0, header.text_size) != source.text) {
+            return {};
+        }
+        data.remove_prefix(header.text_size);
+
+        TokenStore store;
+        if (!store.deserialize(data, source)) return {};
+
+        uint64 n;
+        if (!take(data, n)) return {};
+        std::vector<Diagnostic> diagnostics = {};
+        for (uint64 i = 0; i < n; i++) {
+            uint8            kind;
+            std::string_view name, msg, appendix;
+            uint32           code;
+            uint64           n_tokens;
+            if (!take(data, kind) || kind > Diagnostic::NOTE || !takeString(data, name) || !takeString(data, msg) ||
+                !takeString(data, appendix) || !take(data, code) || !take(data, n_tokens)) {
+                return {};
+            }
+
+            std::vector<Token> tokens = {};
+            for (uint64 k = 0; k < n_tokens; k++) {
+                Token            t;
+                uint8            in_file;
+                std::string_view value;
+                if (!take(data, t.type) || !take(data, t.l) || !take(data, t.c) || !take(data, t.offset) ||
+                    !take(data, in_file) || !takeString(data, value)) {
+                    return {};
+                }
+                t.file = in_file ? source.id : NO_FILE;
+                if (in_file && t.offset <= source.text.size() && source.text.substr(t.offset, value.size()) == value) {
+                    t.value = source.text.substr(t.offset, value.size());
+                } else {
+                    t.value = source.keep(String(value));
+                }
+                tokens.push_back(t);
+            }
+            diagnostics.push_back({(Diagnostic::Kind) kind, String(name), tokens, String(msg), code, String(appendix)});
+        }
+        if (!data.empty()) return {};
+        return std::make_pair(std::move(store), std::move(diagnostics));
+    }
+
+    /**
+     * @brief read the cache entry for source if there is a valid one
+     */
+    std::optional<std::pair<TokenStore, std::vector<Diagnostic>>> load(Source& source, uint64 text_hash) {
+        String path = entry(text_hash).string();
+#ifdef CSTC_HAS_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return {};
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+            close(fd);
+            return {};
+        }
+        void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED) return {};
+
+        auto result = parse(std::string_view((const char*) m, st.st_size), source, text_hash);
+        munmap(m, st.st_size);
+        return result;
+#else
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return {};
+        String data((std::istreambuf_iterator<char>(f)), (std::istreambuf_iterator<char>()));
+        return parse(data, source, text_hash);
+#endif
+    }
+} // namespace lexer::cache
+
+/**
+ * @brief get the 64 bit FNV-1a hash of a text
+ */
+uint64 lexer::cache::hash(std::string_view text) {
+    uint64 h = 0xcbf29ce484222325ULL;
+    for (char c : text) { h = (h ^ (uint8) c) * 0x100000001b3ULL; }
+    return h;
+}
+
+/**
+ * @brief tokenize a Source, using the cache if possible. Cache entries are keyed by a hash of the text,
+ * VERSION and lexer::pretty_size and hold the text, the tokens and all lexer diagnostics, which are shown
+ * again on a cache hit. An entry is only used if its text is the one tokenized. Entries that are damaged, truncated or from another VERSION are not used, the Source is
+ * lexed and the entry written again. Gives the same result as lexer::tokenize.
+ *
+ * @return Vector of Tokens tokenized. The tokens refer to source and must not outlive it.
+ */
+lexer::TokenStream lexer::cache::tokenize(Source& source) {
+    if (!enabled) return lexer::tokenize(source);
+
+    uint64 text_hash = hash(source.text);
+    if (auto hit = load(source, text_hash)) {
+        for (const Diagnostic& d : hit->second) show(d);
+        TokenStream tokens = TokenStream::of(std::move(hit->first));
+        attachLiterals(source, tokens);
+        tokens.attachTo(source);
+        return tokens;
+    }
+
+    std::vector<Diagnostic>* outer       = recorded;
+    std::vector<Diagnostic>  diagnostics = {};
+    recorded                             = &diagnostics;
+    TokenStream tokens                   = lexer::tokenize(source);
+    recorded                             = outer;
+    if (outer != nullptr) outer->insert(outer->end(), diagnostics.begin(), diagnostics.end());
+
+    if (!tokens.empty()) { // empty results are not cached, as tokenize writes some messages directly
+        store(source, text_hash, tokens, diagnostics);
+    }
+    return tokens;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+//
+// CACHE.hpp
+//
+// layouts the on-disk token cache
+//
+
+#include "../snippets.h"
+#include "source.hpp"
+#include "token.hpp"
+
+namespace lexer {
+    namespace cache {
+        constexpr uint32 VERSION = 4; //> cache version. Has to be bumped whenever tokenize's output or the format changes
+
+        extern bool   enabled;   //> whether the cache is used at all
+        extern String directory; //> where cached tokens are stored
+
+        /**
+         * @brief tokenize a Source, using the cache if possible. Cache entries are keyed by a hash of the text,
+         * VERSION and lexer::pretty_size and hold the text, the tokens and all lexer diagnostics, which are
+         * shown again on a cache hit. An entry is only used if its text is the one tokenized. Entries that are damaged, truncated or from another VERSION are not used, the Source is
+         * lexed and the entry written again. Gives the same result as lexer::tokenize.
+         *
+         * @return Vector of Tokens tokenized. The tokens refer to source and must not outlive it.
+         */
+        TokenStream tokenize(Source& source);
+
+        /**
+         * @brief get the 64 bit FNV-1a hash of a text
+         */
+        uint64 hash(std::string_view text);
+    } // namespace cache
+} // namespace lexer
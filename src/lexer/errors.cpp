@@ -10,13 +10,47 @@
 
 #include "../parser/errors.hpp"
 
+thread_local std::vector<lexer::Diagnostic>* lexer::held     = nullptr;
+thread_local std::vector<lexer::Diagnostic>* lexer::recorded = nullptr;
+
 void lexer::error(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
+    if (held != nullptr) {
+        held->push_back({Diagnostic::ERROR, name, tokens, msg, code, appendix});
+        return;
+    }
+    if (recorded != nullptr) { recorded->push_back({Diagnostic::ERROR, name, tokens, msg, code, appendix}); }
     parser::showError("ERROR", "\e[1;31m", "\e[31m", name, msg, tokens, code, appendix);
 }
 void lexer::warn(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
+    if (held != nullptr) {
+        held->push_back({Diagnostic::WARNING, name, tokens, msg, code, appendix});
+        return;
+    }
+    if (recorded != nullptr) { recorded->push_back({Diagnostic::WARNING, name, tokens, msg, code, appendix}); }
     parser::showError("WARNING", "\e[1;33m", "\e[33m", name, msg, tokens, code, appendix);
 }
 void lexer::note(std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
+    if (held != nullptr) {
+        held->push_back({Diagnostic::NOTE, "", tokens, msg, code, appendix});
+        return;
+    }
+    if (recorded != nullptr) { recorded->push_back({Diagnostic::NOTE, "", tokens, msg, code, appendix}); }
     parser::showError("NOTE", "\e[1;36m", "\e[36m", "", msg, tokens, code, appendix);
 }
 
+void lexer::show(const Diagnostic& d){
+    switch (d.kind) {
+        case Diagnostic::ERROR:   error(d.name, d.tokens, d.msg, d.code, d.appendix); break;
+        case Diagnostic::WARNING: warn(d.name, d.tokens, d.msg, d.code, d.appendix); break;
+        case Diagnostic::NOTE:    note(d.tokens, d.msg, d.code, d.appendix); break;
+    }
+}
+
+lexer::Hold::Hold(std::vector<Diagnostic>& diagnostics) {
+    outer = held;
+    held  = &diagnostics;
+}
+
+lexer::Hold::~Hold() {
+    held = outer;
+}
@@ -17,8 +17,45 @@ but this might change in the future, so the lexer errors are different functions
 */
 
 namespace lexer {
+    /**
+     * @struct Diagnostic a lexer message that was held back instead of being shown
+     */
+    struct Diagnostic {
+            enum Kind { ERROR, WARNING, NOTE };
+
+            Kind               kind;
+            String             name;
+            std::vector<Token> tokens;
+            String             msg;
+            uint32             code;
+            String             appendix;
+    };
+
+    extern thread_local std::vector<Diagnostic>* held;     //> if set, this thread's messages are collected there instead
+    extern thread_local std::vector<Diagnostic>* recorded; //> if set, this thread's messages are also copied there
+
     extern void error(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix = "");
     extern void warn(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix = "");
     extern void note(std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix = "");
+
+    /**
+     * @brief show a held back message
+     */
+    extern void show(const Diagnostic& d);
+
+    /**
+     * @class Hold collects this thread's messages in diagnostics while it lives. Whatever held them before holds them
+     * again afterwards
+     */
+    class Hold final {
+            std::vector<Diagnostic>* outer; //> held when this was made
+
+        public:
+            Hold(std::vector<Diagnostic>& diagnostics);
+            ~Hold();
+
+            Hold(const Hold&)            = delete;
+            Hold& operator=(const Hold&) = delete;
+    };
 } // namespace lexer
 
@@ -9,14 +9,231 @@
 
 #include "../snippets.h"
 #include "errors.hpp"
+#include "scan.hpp"
+#include "source.hpp"
 #include "token.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
-#include <regex>
+#include <string_view>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
-int32 lexer::pretty_size = 120; //> max line len before warning
+int32  lexer::pretty_size  = 120;     //> max line len before warning
+uint32 lexer::threads      = 0;       //> lexer threads for large files. 0 => one per hardware thread
+uint64 lexer::parallel_min = 4 << 20; //> files smaller than this are always lexed serially
+
+namespace lexer {
+    namespace table {
+        /**
+         * @brief character classes used by the scanner. A char may be part of multiple classes.
+         */
+        enum CharClass : uint8 {
+            WORD     = 0,      //> no special meaning, ends up in the word buffer
+            DELIM    = 1 << 0, //> whitespace delimiter
+            SINGLE   = 1 << 1, //> single char token (may start a double token)
+            ML_STOP  = 1 << 2, //> chars that have to be inspected inside of a multiline comment
+        };
+
+        /**
+         * @brief lookup tables for the scanner, built at compile time
+         */
+        struct CharTables {
+                Token::Type single[256] = {}; //> single token type by char
+                uint8       cls[256]    = {}; //> CharClass bitmask by char
+        };
+
+        constexpr CharTables buildCharTables() {
+            CharTables t;
+            const char*       chars = ";=+-*/%~&|^!<>?:#@.,(){}[]";
+            const Token::Type types[] = {
+                Token::Type::END_CMD,    Token::Type::SET,         Token::Type::ADD,        Token::Type::SUB,
+                Token::Type::MUL,        Token::Type::DIV,         Token::Type::MOD,        Token::Type::NEG,
+                Token::Type::AND,        Token::Type::OR,          Token::Type::XOR,        Token::Type::NOT,
+                Token::Type::LESS,       Token::Type::GREATER,     Token::Type::QM,         Token::Type::IN,
+                Token::Type::ADDR,       Token::Type::LIFETIME,    Token::Type::ACCESS,     Token::Type::COMMA,
+                Token::Type::OPEN,       Token::Type::CLOSE,       Token::Type::BLOCK_OPEN, Token::Type::BLOCK_CLOSE,
+                Token::Type::INDEX_OPEN, Token::Type::INDEX_CLOSE,
+            };
+            for (uint32 i = 0; chars[i] != 0; i++) {
+                t.single[(uint8) chars[i]]  = types[i];
+                t.cls[(uint8) chars[i]]    |= SINGLE;
+            }
+            t.cls[(uint8) ' ']  |= DELIM;
+            t.cls[(uint8) '\t'] |= DELIM;
+            t.cls[(uint8) '\n'] |= DELIM | ML_STOP;
+            t.cls[(uint8) '/']  |= ML_STOP;
+            t.cls[(uint8) '*']  |= ML_STOP;
+            return t;
+        }
+
+        constexpr CharTables chars = buildCharTables();
+        static_assert(Token::Type::NONE == 0, "char tables rely on NONE being the zero value");
+
+        /**
+         * @brief keyword table entry
+         */
+        struct Keyword {
+                std::string_view name;
+                Token::Type      type;
+        };
+
+        constexpr Keyword keywords[] = {
+            {"true",      Token::Type::BOOL     },
+            {"false",     Token::Type::BOOL     },
+            {"as",        Token::Type::AS       },
+            {"if",        Token::Type::IF       },
+            {"else",      Token::Type::ELSE     },
+            {"for",       Token::Type::FOR      },
+            {"while",     Token::Type::WHILE    },
+            {"return",    Token::Type::RETURN   },
+            {"continue",  Token::Type::CONTINUE },
+            {"break",     Token::Type::BREAK    },
+            {"namespace", Token::Type::NAMESPACE},
+            {"import",    Token::Type::IMPORT   },
+            {"noimpl",    Token::Type::NOIMPL   },
+            {"class",     Token::Type::CLASS    },
+            {"struct",    Token::Type::STRUCT   },
+            {"enum",      Token::Type::ENUM     },
+            {"mut",       Token::Type::MUT      },
+            {"abstract",  Token::Type::ABSTRACT },
+            {"do",        Token::Type::DO       },
+            {"public",    Token::Type::PUBLIC   },
+            {"switch",    Token::Type::SWITCH   },
+            {"case",      Token::Type::CASE     },
+            {"private",   Token::Type::PRIVATE  },
+            {"protected", Token::Type::PROTECTED},
+            {"const",     Token::Type::CONST    },
+            {"static",    Token::Type::STATIC   },
+            {"throw",     Token::Type::THROW    },
+            {"catch",     Token::Type::CATCH    },
+            {"try",       Token::Type::TRY      },
+            {"new",       Token::Type::NEW      },
+            {"virtual",   Token::Type::VIRTUAL  },
+            {"delete",    Token::Type::DELETE   },
+            {"operator",  Token::Type::OPERATOR },
+            {"finally",   Token::Type::FINALLY  },
+            {"nowrap",    Token::Type::NOWRAP   },
+            {"null",      Token::Type::NULV     },
+            {"x",         Token::Type::X        },
+        };
+
+        constexpr uint32 KEYWORD_COUNT   = sizeof(keywords) / sizeof(Keyword);
+        constexpr uint32 KEYWORD_SLOTS   = 256; //> hash table size, has to be a power of two
+        constexpr uint64 KEYWORD_MAX_LEN = 9;   //> longest keyword ("namespace", "protected")
+
+        /**
+         * @brief seeded FNV-1a, reduced to a keyword table slot
+         */
+        constexpr uint32 keywordHash(std::string_view s, uint32 seed) {
+            uint32 h = 2166136261u ^ seed;
+            for (char c : s) {
+                h ^= (uint8) c;
+                h *= 16777619u;
+            }
+            return (h ^ (h >> 15)) & (KEYWORD_SLOTS - 1);
+        }
+
+        /**
+         * @brief find the first seed for which keywordHash has no collisions on the keyword set
+         */
+        constexpr uint32 findKeywordSeed() {
+            for (uint32 seed = 0;; seed++) {
+                bool used[KEYWORD_SLOTS] = {};
+                bool ok                  = true;
+                for (uint32 i = 0; i < KEYWORD_COUNT && ok; i++) {
+                    uint32 h = keywordHash(keywords[i].name, seed);
+                    ok       = !used[h];
+                    used[h]  = true;
+                }
+                if (ok) return seed;
+            }
+        }
+
+        constexpr uint32 keyword_seed = findKeywordSeed();
+
+        /**
+         * @brief perfect hash table mapping a slot to a keyword index (+1, 0 = empty)
+         */
+        struct KeywordSlots {
+                uint8 index[KEYWORD_SLOTS] = {};
+        };
+
+        constexpr KeywordSlots buildKeywordSlots() {
+            KeywordSlots t;
+            for (uint32 i = 0; i < KEYWORD_COUNT; i++) { t.index[keywordHash(keywords[i].name, keyword_seed)] = i + 1; }
+            return t;
+        }
+
+        constexpr KeywordSlots keyword_slots = buildKeywordSlots();
+
+        constexpr bool keywordTableIsPerfect() {
+            for (uint32 i = 0; i < KEYWORD_COUNT; i++) {
+                if (keyword_slots.index[keywordHash(keywords[i].name, keyword_seed)] != i + 1) return false;
+                if (keywords[i].name.size() > KEYWORD_MAX_LEN) return false;
+            }
+            return true;
+        }
+
+        static_assert(keywordTableIsPerfect(), "keyword hash has collisions");
+
+        /**
+         * @brief look up a keyword. Returns Token::Type::NONE if s is no keyword
+         */
+        inline Token::Type keyword(std::string_view s) {
+            if (s.size() > KEYWORD_MAX_LEN) return Token::Type::NONE;
+            uint8 idx = keyword_slots.index[keywordHash(s, keyword_seed)];
+            if (idx != 0 && keywords[idx - 1].name == s) return keywords[idx - 1].type;
+            return Token::Type::NONE;
+        }
+
+        inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+        inline bool isHexDigit(char c) { return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+        inline bool isBinDigit(char c) { return c == '0' || c == '1'; }
+
+        /**
+         * @brief check if all chars of s (starting at start) match check. s has to be longer than start
+         */
+        template <typename F>
+        inline bool allOf(std::string_view s, uint64 start, F check) {
+            if (s.size() <= start) return false;
+            for (uint64 i = start; i < s.size(); i++) {
+                if (!check(s[i])) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief get the value of a (hexadecimal) digit
+         */
+        inline uint8 digitValue(char c) {
+            if (isDigit(c)) return c - '0';
+            return (c | 0x20) - 'a' + 10;
+        }
+
+        /**
+         * @brief char escapes and the values they stand for
+         */
+        constexpr std::pair<char, uint32> escapes[] = {
+            {'n',  0x0A},
+            {'t',  0x09},
+            {'v',  0x0B},
+            {'f',  0x0C},
+            {'r',  0x0D},
+            {'a',  0x07},
+            {'"',  0x22},
+            {'\\', 0x5C},
+            {'\'', 0x27},
+        };
+    } // namespace table
+} // namespace lexer
 
 /**
  * @brief try to fit a delimiting token into a single-char buffer
@@ -24,70 +241,45 @@ int32 lexer::pretty_size = 120; //> max line len before warning
  * @return token type found or Token::Type::NONE. @see @enum lexer::Token::Type
  */
 lexer::Token::Type lexer::getSingleToken(char c) {
-    switch (c) {
-        case ';' : return lexer::Token::Type::END_CMD;
-
-        case '=' : return lexer::Token::Type::SET;
-        case '+' : return lexer::Token::Type::ADD;
-        case '-' : return lexer::Token::Type::SUB;
-        case '*' : return lexer::Token::Type::MUL;
-        case '/' : return lexer::Token::Type::DIV;
-        case '%' : return lexer::Token::Type::MOD;
-        case '~' : return lexer::Token::Type::NEG;
-        case '&' : return lexer::Token::Type::AND;
-        case '|' : return lexer::Token::Type::OR;
-        case '^' : return lexer::Token::Type::XOR;
-        case '!' : return lexer::Token::Type::NOT;
-
-        case '<' : return lexer::Token::Type::LESS;
-        case '>' : return lexer::Token::Type::GREATER;
-
-        case '?' : return lexer::Token::Type::QM;
-        case ':' : return lexer::Token::Type::IN;
-        case '#' : return lexer::Token::Type::ADDR;
-        case '@' : return lexer::Token::Type::LIFETIME;
-        case '.' : return lexer::Token::Type::ACCESS;
-        case ',' : return lexer::Token::Type::COMMA;
-
-        case '(' : return lexer::Token::Type::OPEN;
-        case ')' : return lexer::Token::Type::CLOSE;
-        case '{' : return lexer::Token::Type::BLOCK_OPEN;
-        case '}' : return lexer::Token::Type::BLOCK_CLOSE;
-        case '[' : return lexer::Token::Type::INDEX_OPEN;
-        case ']' : return lexer::Token::Type::INDEX_CLOSE;
-        default  : return lexer::Token::Type::NONE;
-    }
+    return table::chars.single[(uint8) c];
 }
 
 /**
- * @brief try to fit a delimiting token into a string
- *
- * @param s String has to have length 2!
+ * @brief try to fit a delimiting token into a pair of chars
  *
  * @return token type found or Token::Type::NONE. @see @enum lexer::Token::Type
  */
-lexer::Token::Type lexer::getDoubleToken(String s) {
-    if (s == "++") { return lexer::Token::Type::INC; }
-    if (s == "--") { return lexer::Token::Type::DEC; }
-    if (s == "**") { return lexer::Token::Type::POW; }
-
-    if (s == "<<") { return lexer::Token::Type::SHL; }
-    if (s == ">>") { return lexer::Token::Type::SHR; }
-    if (s == "!>") { return lexer::Token::Type::LSHR; }
-
-    if (s == "&&") { return lexer::Token::Type::LAND; }
-    if (s == "||") { return lexer::Token::Type::LOR; }
-
-    if (s == "==") { return lexer::Token::Type::EQ; }
-    if (s == "!=") { return lexer::Token::Type::NEQ; }
-    if (s == ">=") { return lexer::Token::Type::GEQ; }
-    if (s == "<=") { return lexer::Token::Type::LEQ; }
-
-    if (s == "<-") { return lexer::Token::Type::UNPACK; }
-    if (s == "::") { return lexer::Token::Type::SUBNS; }
-    if (s == "..") { return lexer::Token::Type::DOTDOT; }
-
-    return lexer::Token::Type::NONE;
+lexer::Token::Type lexer::getDoubleToken(char a, char b) {
+    switch (a) {
+        case '+' : return b == '+' ? lexer::Token::Type::INC : lexer::Token::Type::NONE;
+        case '-' : return b == '-' ? lexer::Token::Type::DEC : lexer::Token::Type::NONE;
+        case '*' : return b == '*' ? lexer::Token::Type::POW : lexer::Token::Type::NONE;
+        case '&' : return b == '&' ? lexer::Token::Type::LAND : lexer::Token::Type::NONE;
+        case '|' : return b == '|' ? lexer::Token::Type::LOR : lexer::Token::Type::NONE;
+        case '=' : return b == '=' ? lexer::Token::Type::EQ : lexer::Token::Type::NONE;
+        case ':' : return b == ':' ? lexer::Token::Type::SUBNS : lexer::Token::Type::NONE;
+        case '.' : return b == '.' ? lexer::Token::Type::DOTDOT : lexer::Token::Type::NONE;
+        case '<' :
+            switch (b) {
+                case '<' : return lexer::Token::Type::SHL;
+                case '=' : return lexer::Token::Type::LEQ;
+                case '-' : return lexer::Token::Type::UNPACK;
+                default  : return lexer::Token::Type::NONE;
+            }
+        case '>' :
+            switch (b) {
+                case '>' : return lexer::Token::Type::SHR;
+                case '=' : return lexer::Token::Type::GEQ;
+                default  : return lexer::Token::Type::NONE;
+            }
+        case '!' :
+            switch (b) {
+                case '>' : return lexer::Token::Type::LSHR;
+                case '=' : return lexer::Token::Type::NEQ;
+                default  : return lexer::Token::Type::NONE;
+            }
+        default : return lexer::Token::Type::NONE;
+    }
 }
 
 /**
@@ -97,118 +289,139 @@ lexer::Token::Type lexer::getDoubleToken(String s) {
  *
  * @return token type found or Token::Type::NONE. @see @enum lexer::Token::Type
  */
-lexer::Token::Type lexer::matchType(String c) {
-    // fallback = everything else
-    lexer::Token::Type type = lexer::Token::Type::ID;
-
-    // bool literal
-    if (c == "true" || c == "false") { return lexer::Token::Type::BOOL; }
-
-    // int literal
-    const std::regex int_regex("[0-9]+");
-    const std::regex hex_regex("0x[0-9a-fA-F]+");
-    const std::regex binary_regex("0b[0-1]+");
-
-    if (regex_match(c.c_str(), int_regex)) { return lexer::Token::Type::INT; }
-    if (regex_match(c.c_str(), hex_regex)) { return lexer::Token::Type::HEX; }
-    if (regex_match(c.c_str(), binary_regex)) { return lexer::Token::Type::BINARY; }
+lexer::Token::Type lexer::matchType(std::string_view c) {
+    if (c.empty()) { return lexer::Token::Type::ID; }
+
+    // int literals
+    if (table::isDigit(c[0])) {
+        if (table::allOf(c, 0, table::isDigit)) { return lexer::Token::Type::INT; }
+        if (c[0] == '0' && c.size() > 2) {
+            if (c[1] == 'x' && table::allOf(c, 2, table::isHexDigit)) { return lexer::Token::Type::HEX; }
+            if (c[1] == 'b' && table::allOf(c, 2, table::isBinDigit)) { return lexer::Token::Type::BINARY; }
+        }
+        return lexer::Token::Type::ID;
+    }
 
     // char & String literal
     if (c[0] == '\'' && c[c.size() - 1] == '\'') { return lexer::Token::Type::CHAR; }
     if (c[0] == '\"' && c[c.size() - 1] == '\"') { return lexer::Token::Type::STRING; }
 
-    // Keywords
-    if (c == "as") {
-        type = lexer::Token::Type::AS;
-    } else if (c == "if") {
-        type = lexer::Token::Type::IF;
-    } else if (c == "else") {
-        type = lexer::Token::Type::ELSE;
-    } else if (c == "for") {
-        type = lexer::Token::Type::FOR;
-    } else if (c == "while") {
-        type = lexer::Token::Type::WHILE;
-    } else if (c == "return") {
-        type = lexer::Token::Type::RETURN;
-    } else if (c == "continue") {
-        type = lexer::Token::Type::CONTINUE;
-    } else if (c == "break") {
-        type = lexer::Token::Type::BREAK;
-    } else if (c == "namespace") {
-        type = lexer::Token::Type::NAMESPACE;
-    } else if (c == "import") {
-        type = lexer::Token::Type::IMPORT;
-    } else if (c == "noimpl") {
-        type = lexer::Token::Type::NOIMPL;
-    } else if (c == "class") {
-        type = lexer::Token::Type::CLASS;
-    } else if (c == "struct") {
-        type = lexer::Token::Type::STRUCT;
-    } else if (c == "enum") {
-        type = lexer::Token::Type::ENUM;
-    } else if (c == "mut") {
-        type = lexer::Token::Type::MUT;
-    } else if (c == "abstract") {
-        type = lexer::Token::Type::ABSTRACT;
-    } else if (c == "do") {
-        type = lexer::Token::Type::DO;
-    } else if (c == "public") {
-        type = lexer::Token::Type::PUBLIC;
-    } else if (c == "switch") {
-        type = lexer::Token::Type::SWITCH;
-    } else if (c == "case") {
-        type = lexer::Token::Type::CASE;
-    } else if (c == "private") {
-        type = lexer::Token::Type::PRIVATE;
-    } else if (c == "protected") {
-        type = lexer::Token::Type::PROTECTED;
-    } else if (c == "const") {
-        type = lexer::Token::Type::CONST;
-    } else if (c == "static") {
-        type = lexer::Token::Type::STATIC;
-    } else if (c == "throw") {
-        type = lexer::Token::Type::THROW;
-    } else if (c == "catch") {
-        type = lexer::Token::Type::CATCH;
-    } else if (c == "try") {
-        type = lexer::Token::Type::TRY;
-    } else if (c == "new") {
-        type = lexer::Token::Type::NEW;
-    } else if (c == "virtual") {
-        type = lexer::Token::Type::VIRTUAL;
-    } else if (c == "delete") {
-        type = lexer::Token::Type::DELETE;
-    } // Not sure about this
-    else if (c == "operator") {
-        type = lexer::Token::Type::OPERATOR;
-    } else if (c == "finally") {
-        type = lexer::Token::Type::FINALLY;
-    } else if (c == "nowrap") {
-        type = lexer::Token::Type::NOWRAP;
-    } else if (c == "null") {
-        type = lexer::Token::Type::NULV;
-    } else if (c == "x") {
-        type = lexer::Token::Type::X;
+    // Keywords (including bool literals), fallback = everything else
+    lexer::Token::Type type = table::keyword(c);
+    return type == lexer::Token::Type::NONE ? lexer::Token::Type::ID : type;
+}
+
+/**
+ * @brief decode the value of a literal token
+ *
+ * @param type the token's type
+ * @param s the token's contents
+ *
+ * @return the value or a Literal of kind NONE if type is no INT, HEX, BINARY, FLOAT or CHAR
+ */
+lexer::Literal lexer::decode(lexer::Token::Type type, std::string_view s) {
+    Literal l;
+    switch (type) {
+        case Token::Type::INT :
+        case Token::Type::HEX :
+        case Token::Type::BINARY : {
+            uint64 base  = type == Token::Type::INT ? 10 : type == Token::Type::HEX ? 16 : 2;
+            uint64 start = type == Token::Type::INT ? 0 : 2;
+            l.kind       = Literal::INTEGER;
+            for (uint64 i = start; i < s.size(); i++) {
+                uint64 digit = table::digitValue(s[i]);
+                if (l.integer > (UINT64_MAX - digit) / base) l.overflow = true;
+                l.integer = l.integer * base + digit;
+            }
+            return l;
+        }
+        case Token::Type::FLOAT :
+            l.kind     = Literal::FLOATING;
+            l.floating = std::strtold(String(s).c_str(), nullptr);
+            return l;
+        case Token::Type::CHAR :
+            l.kind = Literal::CODEPOINT;
+            if (s.size() == 3) { // also '\', which has always been taken as a backslash
+                l.code_point = (uint8) s[1];
+                l.valid      = true;
+            } else if (s.size() == 4 && s[1] == '\\') {
+                for (const auto& [c, value] : table::escapes) {
+                    if (s[2] == c) {
+                        l.code_point = value;
+                        l.valid = l.escape = true;
+                    }
+                }
+            } else if (s.size() == 8 && s[1] == '\\' && s[2] == 'u' && table::allOf(s.substr(0, 7), 3, table::isHexDigit)) {
+                for (uint64 i = 3; i < 7; i++) l.code_point = l.code_point * 16 + table::digitValue(s[i]);
+                l.valid = l.escape = true;
+            }
+            return l;
+        default : return l;
     }
+}
 
-    return type;
+/**
+ * @brief decode the values of all literal tokens of a Source and attach them to it, so the parser
+ * does not have to convert their contents again. @see Source::literal
+ *
+ * @param tokens the Source's tokens
+ */
+void lexer::attachLiterals(Source& source, const TokenStream& tokens) {
+    std::vector<std::pair<uint64, Literal>> literals = {};
+    for (uint64 i = 0; i < tokens.size(); i++) {
+        Token::Type type = tokens.type(i);
+        if (type != Token::Type::INT && type != Token::Type::HEX && type != Token::Type::BINARY &&
+            type != Token::Type::FLOAT && type != Token::Type::CHAR) {
+            continue;
+        }
+        Token t = tokens[i];
+        if (t.file == source.id && t.value.data() == source.text.data() + t.offset) {
+            literals.push_back({t.offset, decode(type, t.value)});
+        }
+    }
+    source.setLiterals(std::move(literals));
 }
 
 /**
  * @brief check if a is a delimiter
  */
-#define delimiter(a) a == ' ' || a == '\t' || a == '\n'
+#define delimiter(a) (table::chars.cls[(uint8) (a)] & table::DELIM)
+
+/**
+ * @brief stop lexing if the last token pushed lets an incremental re-lex continue with the old tokens
+ */
+#define checkResync()                                                      \
+    if (resync != nullptr && resync->matches(tokens.at(tokens.size() - 1))) { \
+        return true;                                                       \
+    }
 
 /**
  * @brief handle and clear the buffer (add a token if the buffer is not empty)
  */
 #define handleBuffer()                                                                                         \
-    if (buffer.size() > 0) {                                                                                   \
-        tokens.push_back(Token(matchType(buffer), buffer, line, col - buffer.size(), filename, lc));           \
+    if (buffer_size > 0) {                                                                                     \
+        std::string_view word =                                                                                \
+            buffer_copy.empty() ? text.substr(buffer_start, buffer_size) : source.keep(buffer_copy);           \
+        tokens.push_back(Token(matchType(word), word, line, col - buffer_size, source.id, buffer_start));      \
         if (pretty_size != -1 && col > (uint64) pretty_size) too_long.push_back(tokens.at(tokens.size() - 1)); \
-        buffer = "";                                                                                           \
+        buffer_size = 0;                                                                                       \
+        buffer_copy.clear();                                                                                   \
+        checkResync();                                                                                         \
     }
 
+/**
+ * @brief add n chars of text starting at from to the buffer. The buffer only gets copied if it
+ * would not be contiguous in text otherwise
+ */
+#define bufferAppend(from, n)                                               \
+    if (buffer_size == 0) {                                                 \
+        buffer_start = from;                                                \
+    } else if (buffer_copy.empty() && buffer_start + buffer_size != from) { \
+        buffer_copy = text.substr(buffer_start, buffer_size);               \
+    }                                                                       \
+    if (!buffer_copy.empty()) { buffer_copy.append(text, from, n); }        \
+    buffer_size += n;
+
 /**
  * @brief Update Variables and raise Warning if line is too long
  */
@@ -217,7 +430,6 @@ lexer::Token::Type lexer::matchType(String c) {
         line_comment = false;                                                                          \
         line++;                                                                                        \
         col = 0;                                                                                       \
-        lc  = share<String>(new String);                                                               \
         if (too_long.size() > 0) {                                                                     \
             warn("Line too long", {too_long}, "It will become hard to read if you do long lines", 14); \
             note(too_long,                                                                             \
@@ -228,33 +440,273 @@ lexer::Token::Type lexer::matchType(String c) {
         }                                                                                              \
     }
 
+namespace lexer {
+    /**
+     * @brief lexer state that is carried over line breaks
+     */
+    struct LexState {
+            uint64 ml_comment = 0; //> multiline comment level. If 0 => no comment
+            Token  ml_open;        //> cached fist multiline open
+    };
+
+    /**
+     * @brief decides where an incremental re-lex may stop and continue with the previous tokens.
+     * @see lexer::retokenize
+     */
+    struct Resync {
+            const std::vector<Token>& old;        //> previous tokens
+            uint64                    min_offset; //> old tokens starting before this offset were affected by the edit
+            uint64                    min_line;   //> old tokens have to start on a line after this one
+            int64                     delta;      //> offset shift caused by the edit
+            int64                     line_delta; //> line shift caused by the edit
+            uint64                    at = 0;     //> index of the old token matched
+
+            /**
+             * @brief check if t is an old token that started a line and was lexed from the same state as before.
+             * From then on both lexer runs see the same text in the same state, so the old tokens can be reused.
+             */
+            bool matches(const Token& t) {
+                int64 old_offset = (int64) t.offset - delta;
+                if (old_offset < (int64) min_offset) return false;
+
+                auto it = std::lower_bound(old.begin(), old.end(), (uint64) old_offset, [](const Token& a, uint64 o) {
+                    return a.offset < o;
+                });
+                if (it == old.end() || it->offset != (uint64) old_offset) return false;
+                if (it->l <= min_line) return false;
+                if (it != old.begin() && (it - 1)->l == it->l) return false; // has to be the first token of its line
+                if (it->type != t.type || it->value != t.value || it->c != t.c) return false;
+                if ((int64) it->l + line_delta != (int64) t.l) return false;
+
+                at = it - old.begin();
+                return true;
+            }
+    };
+
+    /**
+     * @brief tokenize the text of source between the offsets from and to. The lexer starts with an empty buffer
+     * at the given line and column and the comment state in state, which is updated. Tokens are appended to tokens.
+     * to has to be the end of the text or right after a line break.
+     *
+     * @param resync if given, stop as soon as it matches a token
+     *
+     * @return false if the rest of the file had to be dropped (unresolved merge conflict)
+     */
+    bool lexRange(Source& source, uint64 from, uint64 to, uint64 line, uint64 col, LexState& state,
+                  std::vector<Token>& tokens, Resync* resync);
+
+    /**
+     * @brief tokenize source on n threads, @see lexer::tokenize
+     */
+    bool lexParallel(Source& source, uint32 n, std::vector<Token>& tokens, LexState& state);
+
+    /**
+     * @brief warn about a multiline comment that is still open at the end of the file
+     */
+    void unclosedComment(const LexState& state) {
+        if (state.ml_comment > 0) {
+            lexer::warn("Unclosed multiline comment",
+                        {state.ml_open},
+                        "This multiline comment was never closed. This could cause problems with commented code",
+                        0);
+        }
+    }
+
+    /**
+     * @brief get the line an offset of text is on, counting from the closest token before it
+     */
+    uint64 lineAt(const std::vector<Token>& tokens, std::string_view text, uint64 offset) {
+        auto it = std::upper_bound(tokens.begin(), tokens.end(), offset, [](uint64 o, const Token& a) {
+            return o < a.offset;
+        });
+        if (it == tokens.begin()) return 1 + std::count(text.begin(), text.begin() + offset, '\n');
+        it--;
+        return it->l + std::count(text.begin() + it->offset, text.begin() + offset, '\n');
+    }
+
+    /**
+     * @brief move an unchanged token to the edited Source
+     */
+    Token moveToken(const Token& t, const Source& from, const Source& to, int64 delta, int64 line_delta) {
+        Token moved   = t;
+        moved.file    = to.id;
+        moved.offset += delta;
+        moved.l      += line_delta;
+        if (t.value.data() == from.text.data() + t.offset) { // contiguous tokens get pointed into the new text
+            moved.value = std::string_view(to.text.data() + moved.offset, t.value.size());
+        }
+        return moved;
+    }
+} // namespace lexer
+
+/**
+ * @brief apply this edit to a text
+ */
+String lexer::Edit::apply(std::string_view text) const {
+    String out;
+    out.reserve(text.size() - length + replacement.size());
+    out.append(text.substr(0, offset));
+    out.append(replacement);
+    out.append(text.substr(offset + length));
+    return out;
+}
+
+/**
+ * @brief get a list of tokens from a Source. Might issue warnings that defer further processing.
+ * Files of at least parallel_min bytes are split at line breaks and lexed on multiple threads,
+ * giving the same tokens and diagnostics. Unpaired brackets are reported here (@see TokenStream::checkBrackets).
+ *
+ * @return Vector of Tokens tokenized. The tokens refer to source and must not outlive it.
+ */
+lexer::TokenStream lexer::tokenize(Source& source) {
+    std::vector<lexer::Token> tokens = {};
+    LexState                  state  = {};
+    uint32                    n      = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+    bool complete = n > 1 && source.text.size() >= parallel_min
+                      ? lexParallel(source, n, tokens, state)
+                      : lexRange(source, 0, source.text.size(), 1, 0, state, tokens, nullptr);
+    if (!complete) { return TokenStream({}); }
+
+    unclosedComment(state);
+
+    if (tokens.size() == 0) { // Empty file warning
+        std::cerr << "\r\e[1;33mWARNING:\e[0m\e[1m " << source.filename << "\e[0m appears to be empty.\n";
+    }
+    TokenStream stream(tokens);
+    stream.checkBrackets();
+    attachLiterals(source, stream);
+    stream.attachTo(source);
+    return stream;
+}
+
+/**
+ * @brief update a list of tokens after an edit, re-lexing only the lines affected by it.
+ *
+ * @return Vector of Tokens of new_source. Diagnostics are only issued for the re-lexed lines
+ * and for unpaired brackets in the whole file.
+ */
+lexer::TokenStream
+    lexer::retokenize(const TokenStream& previous, Source& old_source, Source& new_source, const Edit& edit) {
+    const std::vector<Token> old = previous.list();
+    if (old.empty() || edit.offset + edit.length > old_source.text.size() ||
+        new_source.text.size() != old_source.text.size() - edit.length + edit.replacement.size()) {
+        return tokenize(new_source);
+    }
+
+    // restart behind the last token on a line before the edit. Everything up to it is unchanged and
+    // the lexer state right after a token is known: no comment, empty buffer.
+    uint64 edit_line = lineAt(old, old_source.text, edit.offset);
+    int64  k         = std::lower_bound(old.begin(), old.end(), edit_line, [](const Token& a, uint64 l) {
+                  return a.l < l;
+              }) - old.begin() - 1;
+    while (k >= 0 && old[k].value.data() != old_source.text.data() + old[k].offset) k--; // needs a contiguous token
+
+    std::vector<Token> tokens = {};
+    tokens.reserve(old.size() + 16);
+    for (int64 i = 0; i <= k; i++) { tokens.push_back(moveToken(old[i], old_source, new_source, 0, 0)); }
+
+    uint64 from = 0, line = 1, col = 0;
+    if (k >= 0) {
+        from = old[k].offset + old[k].value.size();
+        line = old[k].l;
+        col  = old[k].c + old[k].value.size() - 1;
+    }
+
+    // re-lex until a line after the edit starts in the same state as before
+    std::string_view removed = old_source.text.substr(edit.offset, edit.length);
+    Resync           resync  = {old,
+                                edit.offset + edit.length,
+                                edit_line + std::count(removed.begin(), removed.end(), '\n'),
+                                (int64) edit.replacement.size() - (int64) edit.length,
+                                std::count(edit.replacement.begin(), edit.replacement.end(), '\n') -
+                                    std::count(removed.begin(), removed.end(), '\n')};
+    resync.at      = old.size();
+    LexState state = {};
+    if (!lexRange(new_source, from, new_source.text.size(), line, col, state, tokens, &resync)) {
+        return TokenStream({});
+    }
+    if (resync.at == old.size()) { unclosedComment(state); } // lexed up to the end
+
+    for (uint64 i = resync.at + 1; i < old.size(); i++) {
+        tokens.push_back(moveToken(old[i], old_source, new_source, resync.delta, resync.line_delta));
+    }
+    if (tokens.size() == 0) { // Empty file warning
+        std::cerr << "\r\e[1;33mWARNING:\e[0m\e[1m " << new_source.filename << "\e[0m appears to be empty.\n";
+    }
+    TokenStream stream(tokens);
+    stream.checkBrackets();
+    attachLiterals(new_source, stream);
+    stream.attachTo(new_source);
+    return stream;
+}
+
 /**
- * @brief get a list of tokens from a String. Might issue warnings that defer further processing.
+ * @brief tokenize source starting at offset from, where the lexer is in a clean state (no comment, empty buffer)
+ * at the given line and column. Tokens are appended to tokens.
  *
- * @return Vector of Tokens tokenized.
+ * @param resync if given, stop as soon as it matches a token
+ *
+ * @return false if the rest of the file had to be dropped (unresolved merge conflict)
  */
-lexer::TokenStream lexer::tokenize(String text, String filename) {
-    std::vector<lexer::Token> tokens       = {};    //> output Token vector
-    uint64                    col          = 0;     //> current column
-    uint64                    line         = 1;     //> current line
-    bool                      line_comment = false; //> if currently in a line comment
-    uint64                    ml_comment   = 0;     //> multiline comment level. If 0 => no comment
+bool lexer::lexRange(Source& source, uint64 from, uint64 to, uint64 line, uint64 col, LexState& state,
+                     std::vector<Token>& tokens, Resync* resync) {
+    std::string_view text         = source.text;
+    bool             line_comment = false;            //> if currently in a line comment
+    uint64&          ml_comment   = state.ml_comment; //> multiline comment level. If 0 => no comment
 #define NO_COMMENT 0
-    sptr<String> lc = share<String>(
-        new String); //> current line buffer for token debug. Used with an sptr to autodelete when not required
-    Token              ml_open;       //> cached fist multiline open
-    std::vector<Token> too_long = {}; //> Tokens after LTL limit
-
-    String      buffer = ""; //> current token buffer
-    Token::Type t;           //> current Token type
-    for (uint32 i = 0; i < text.size(); i++) {
+    Token&             ml_open  = state.ml_open; //> cached fist multiline open
+    std::vector<Token> too_long = {};            //> Tokens after LTL limit
+
+    uint64      buffer_start = 0;  //> start of the current token buffer in text
+    uint64      buffer_size  = 0;  //> size of the current token buffer
+    String      buffer_copy  = ""; //> copy of the current token buffer, only used if it is not contiguous in text
+    Token::Type t;                 //> current Token type
+
+    const scan::Scanner& scanner = scan::scanner(); //> vectorized scanning functions
+    for (uint64 i = from; i < to; i++) {
         // update variables
         char c = text[i];
-        col++;
-        if (c != '\n') {
-            *lc += c; // add char to line buffer
+
+        // fast paths: consume runs of chars without special meaning at once
+        if (line_comment && c != '\n') { // ignore rest of line
+            uint64 end  = scanner.find(text, i, '\n', '\n', '\n');
+            col        += end - i;
+            i           = end - 1;
+            continue;
+        }
+        if (ml_comment > NO_COMMENT && !(table::chars.cls[(uint8) c] & table::ML_STOP)) { // inside of a comment
+            uint64 end  = scanner.find(text, i, '\n', '/', '*');
+            col        += end - i;
+            i           = end - 1;
+            continue;
+        }
+        if (ml_comment == NO_COMMENT && table::chars.cls[(uint8) c] == table::WORD) { // word chars
+            uint64 end = i;
+            do { // identifier chars are skipped vectorized, all other word chars (quotes, \r, ...) one by one
+                end = scanner.skipIdent(text, end);
+                if (end < text.size() && table::chars.cls[(uint8) text[end]] == table::WORD) {
+                    end++;
+                } else {
+                    break;
+                }
+            } while (true);
+            bufferAppend(i, end - i);
+            col += end - i;
+            i    = end - 1;
+            continue;
+        }
+        if (ml_comment == NO_COMMENT && !line_comment && (c == ' ' || c == '\t')) { // blanks
+            col++;
+            handleBuffer();
+            uint64 end  = scanner.skipBlank(text, i + 1);
+            col        += end - (i + 1);
+            i           = end - 1;
+            continue;
         }
 
+        col++;
+
         if (line_comment) { goto update; } // ignore rest of line
 
         // comments
@@ -267,15 +719,14 @@ lexer::TokenStream lexer::tokenize(String text, String filename) {
             handleBuffer();
             ml_comment++;
             if (ml_comment == 1) {
-                ml_open = Token(Token::Type::NONE, "/*", line, col, filename, lc); // cache opening token
+                ml_open = Token(Token::Type::NONE, text.substr(i, 2), line, col, source.id, i); // cache opening token
             }
             goto update;
         }
         if (c == '*' && i < text.size() - 1 && text[i + 1] == '/') {
-            *lc += '/';
             if (ml_comment == NO_COMMENT) {
                 lexer::error("Unopened multiline comment",
-                             {Token(Token::Type::NONE, "*/", line, col, filename, lc)},
+                             {Token(Token::Type::NONE, text.substr(i, 2), line, col, source.id, i)},
                              "This multiline comment was never opened",
                              2350);
             }
@@ -287,49 +738,48 @@ lexer::TokenStream lexer::tokenize(String text, String filename) {
         if (ml_comment > NO_COMMENT) { goto update; } // => in multiline_comment
 
         // Special Error: unresolved Git merge conflict
-        if (c == '<' && text.size() >= i + 12 && text.substr(i, 13) == "<<<<<<<< HEAD") {
-            *lc += "<<<<<<< HEAD"; // Add to line buffer
+        if (c == '<' && text.size() >= i + 12 && text.compare(i, 13, "<<<<<<<< HEAD") == 0) {
             lexer::error(
                 "Unresolved merge conflict",
-                {Token(lexer::Token::Type::NONE, "<<<<<<<< HEAD", line, col, filename, lc)},
+                {Token(lexer::Token::Type::NONE, text.substr(i, 13), line, col, source.id, i)},
                 "There is an unresolved git merge conflict in this file.\nTry\n \e[36m$\e[0m git mergetool\nfor help",
                 -3);
-            while (!std::regex_match(*lc, std::regex(">>>>>>> .*"))) { // move fwd until merge conflict end
-                i++;
-                col++;
-                c = text[i];
-                if (i >= text.size()) { return TokenStream({}); }
-                updateVars();
+            if (text.compare(i - (col - 1), 8, ">>>>>>> ") != 0) { // no conflict end on this line
+                while (++i < to) {                                // => the rest of the file is not tokenized
+                    col++;
+                    c = text[i];
+                    updateVars();
+                }
+                return false;
             }
-            while (i + 1 < text.size() && text[i + 1] != '\n') {
+            while (i + 1 < text.size() && text[i + 1] != '\n') { // skip the rest of the line
                 i++;
                 col++;
                 c = text[i];
-                updateVars()
             }
         }
 
         // Special Token: ...
-        if (i < text.size() - 2) {
+        if (i + 2 < text.size()) {
             if (c == '.' && text[i + 1] == '.' && text[i + 2] == '.') {
                 handleBuffer();
-                tokens.push_back(Token(Token::Type::DOTDOTDOT, "...", line, col, filename, lc));
+                tokens.push_back(Token(Token::Type::DOTDOTDOT, text.substr(i, 3), line, col, source.id, i));
+                checkResync();
                 col += 2;
                 i   += 2;
-                *lc += text.substr(i, 2);
                 goto update;
             }
         }
 
         // Double delimiter Tokens (ex. ||, &&, <<)
         if (i < text.size() - 1) {
-            t = getDoubleToken(""s + c + text[i + 1]);
+            t = getDoubleToken(c, text[i + 1]);
             if (t != Token::Type::NONE) {
                 handleBuffer();
-                tokens.push_back(Token(t, ""s + c + text[i + 1], line, col, filename, lc));
+                tokens.push_back(Token(t, text.substr(i, 2), line, col, source.id, i));
+                checkResync();
                 col++;
-                i   += 1;
-                *lc += text[i];
+                i += 1;
                 goto update;
             }
         }
@@ -338,27 +788,106 @@ lexer::TokenStream lexer::tokenize(String text, String filename) {
         t = getSingleToken(c);
         if (t != Token::Type::NONE) {
             handleBuffer();
-            tokens.push_back(Token(t, ""s + c, line, col, filename, lc));
+            tokens.push_back(Token(t, text.substr(i, 1), line, col, source.id, i));
+            checkResync();
             goto update;
         }
 
         if (delimiter(c)) {
             handleBuffer();
         } else {
-            buffer += c;
+            bufferAppend(i, 1);
         }
 update:
         updateVars();
     }
-    if (ml_comment > NO_COMMENT) { // Some Multiline comment was never closed
-        lexer::warn("Unclosed multiline comment",
-                    {ml_open},
-                    "This multiline comment was never closed. This could cause problems with commented code",
-                    0);
+    return true;
+}
+
+/**
+ * @brief tokenize source on n threads. The text is split into chunks at line breaks, which are lexed
+ * assuming they do not start inside a multiline comment (the only state carried over line breaks).
+ * Chunks where that guess was wrong are lexed again once the state at their start is known.
+ * Diagnostics are held back and shown in order, so the result is the same as lexing serially.
+ *
+ * @return false if the rest of the file had to be dropped (unresolved merge conflict)
+ */
+bool lexer::lexParallel(Source& source, uint32 n, std::vector<Token>& tokens, LexState& state) {
+    struct Chunk {
+            uint64                  from;             //> start offset, at a line start
+            uint64                  to;               //> end offset, after a line break
+            uint64                  lines       = 0;  //> line breaks in this chunk
+            bool                    complete    = true;
+            LexState                end         = {}; //> state at the end of this chunk
+            std::vector<Token>      tokens      = {}; //> tokens, with lines relative to the chunk start
+            std::vector<Diagnostic> diagnostics = {}; //> held back messages, with lines relative to the chunk start
+    };
+    std::string_view text = source.text;
+    if (text.empty()) return true;
+
+    std::vector<Chunk> chunks = {};
+    for (uint64 from = 0; from < text.size();) {
+        uint64 to = std::max(from, text.size() / n * (chunks.size() + 1));
+        if (chunks.size() + 1 >= n || to >= text.size()) {
+            to = text.size();
+        } else {
+            const char* nl = (const char*) std::memchr(text.data() + to, '\n', text.size() - to);
+            to             = nl == nullptr ? text.size() : nl - text.data() + 1;
+        }
+        chunks.push_back({from, to});
+        from = to;
     }
-    if (tokens.size() == 0) { // Empty file warning
-        std::cerr << "\r\e[1;33mWARNING:\e[0m\e[1m " << filename << "\e[0m appears to be empty.\n";
+
+    auto lex = [&source, text](Chunk& chunk, const LexState& start) {
+        chunk.end = start;
+        chunk.tokens.clear();
+        chunk.diagnostics.clear();
+        {
+            Hold hold(chunk.diagnostics);
+            chunk.complete = lexRange(source, chunk.from, chunk.to, 1, 0, chunk.end, chunk.tokens, nullptr);
+        }
+        chunk.lines = std::count(text.begin() + chunk.from, text.begin() + chunk.to, '\n');
+    };
+
+    std::vector<std::thread> workers = {};
+    for (uint64 k = 1; k < chunks.size(); k++) { workers.emplace_back(lex, std::ref(chunks[k]), LexState{}); }
+    lex(chunks[0], state);
+    for (std::thread& w : workers) w.join();
+
+    // resolve the state at each chunk start in order, show diagnostics and find where the tokens go
+    uint64                                 count  = tokens.size(); //> tokens before the current chunk
+    uint64                                 shift  = 0;             //> lines before the current chunk
+    std::vector<std::pair<uint64, uint64>> places = {};            //> first token index and line shift of each chunk
+    for (Chunk& chunk : chunks) {
+        if (&chunk != &chunks[0] && state.ml_comment > 0) { lex(chunk, state); } // started inside of a comment
+
+        for (Diagnostic& d : chunk.diagnostics) {
+            for (Token& t : d.tokens) { t.l += shift; }
+            show(d);
+        }
+        if (!chunk.complete) return false;
+        places.push_back({count, shift});
+        count += chunk.tokens.size();
+
+        state = chunk.end;
+        if (state.ml_comment > 0 && state.ml_open.offset >= chunk.from) { state.ml_open.l += shift; }
+        shift += chunk.lines;
     }
 
-    return TokenStream(tokens);
+    // then copy the tokens into place, again on all threads
+    tokens.resize(count);
+    auto place = [&tokens, &chunks, &places](uint64 k) {
+        Token* out = tokens.data() + places[k].first;
+        for (const Token& t : chunks[k].tokens) {
+            *out    = t;
+            out->l += places[k].second;
+            out++;
+        }
+        std::vector<Token>().swap(chunks[k].tokens);
+    };
+    workers.clear();
+    for (uint64 k = 1; k < chunks.size(); k++) { workers.emplace_back(place, k); }
+    place(0);
+    for (std::thread& w : workers) w.join();
+    return true;
 }
@@ -7,20 +7,54 @@
 //
 
 #include "../snippets.h"
+#include "source.hpp"
 #include "token.hpp"
 
+#include <string_view>
 #include <vector>
 
 namespace lexer {
 
-    extern int32 pretty_size; //> max length before LTL warning
+    extern int32  pretty_size;  //> max length before LTL warning
+    extern uint32 threads;      //> lexer threads for large files. 0 => one per hardware thread
+    extern uint64 parallel_min; //> files smaller than this are always lexed serially
 
     /**
-     * @brief get a list of tokens from a String. Might issue warnings that defer further processing.
+     * @brief get a list of tokens from a Source. Might issue warnings that defer further processing.
+     * Files of at least parallel_min bytes are split at line breaks and lexed on multiple threads,
+     * giving the same tokens and diagnostics. Unpaired brackets are reported here (@see TokenStream::checkBrackets).
      *
-     * @return Vector of Tokens tokenized.
+     * @return Vector of Tokens tokenized. The tokens refer to source and must not outlive it.
      */
-    extern TokenStream tokenize(String text, String filename);
+    extern TokenStream tokenize(Source& source);
+
+    /**
+     * @struct Edit a single change of a text: length bytes at offset are replaced
+     */
+    struct Edit {
+            uint64 offset      = 0;  //> where the edit starts
+            uint64 length      = 0;  //> number of bytes removed
+            String replacement = ""; //> text inserted instead
+
+            /**
+             * @brief apply this edit to a text
+             */
+            String apply(std::string_view text) const;
+    };
+
+    /**
+     * @brief update a list of tokens after an edit, re-lexing only the lines affected by it.
+     * Lexing restarts behind the last token before the edited line and stops as soon as a line after the edit
+     * starts the same way as before; all following tokens are reused with shifted positions.
+     *
+     * @param previous tokens of old_source
+     * @param old_source the Source before the edit
+     * @param new_source the Source after the edit, i.e. with the text edit.apply(old_source.text)
+     *
+     * @return Vector of Tokens of new_source, identical to tokenize(new_source). Diagnostics are only issued
+     * for the re-lexed lines and for unpaired brackets in the whole file.
+     */
+    extern TokenStream retokenize(const TokenStream& previous, Source& old_source, Source& new_source, const Edit& edit);
 
     /**
      * @brief try to fit a delimiting token into a single-char buffer
@@ -30,13 +64,11 @@ namespace lexer {
     extern Token::Type getSingleToken(char c);
 
     /**
-     * @brief try to fit a delimiting token into a string
-     *
-     * @param s String has to have length 2!
+     * @brief try to fit a delimiting token into a pair of chars
      *
      * @return token type found or Token::Type::NONE. @see @enum lexer::Token::Type
      */
-    extern Token::Type getDoubleToken(String s);
+    extern Token::Type getDoubleToken(char a, char b);
 
     /**
      * @brief try to find the token type of a token that does not fit getSingleToken or getDoubleToken
@@ -45,6 +77,24 @@ namespace lexer {
      *
      * @return token type found or Token::Type::NONE. @see @enum lexer::Token::Type
      */
-    extern Token::Type matchType(String s);
+    extern Token::Type matchType(std::string_view s);
+
+    /**
+     * @brief decode the value of a literal token
+     *
+     * @param type the token's type
+     * @param s the token's contents
+     *
+     * @return the value or a Literal of kind NONE if type is no INT, HEX, BINARY, FLOAT or CHAR
+     */
+    extern Literal decode(Token::Type type, std::string_view s);
+
+    /**
+     * @brief decode the values of all literal tokens of a Source and attach them to it, so the parser
+     * does not have to convert their contents again. @see Source::literal
+     *
+     * @param tokens the Source's tokens
+     */
+    extern void attachLiterals(Source& source, const TokenStream& tokens);
 } // namespace lexer
 
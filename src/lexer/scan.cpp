@@ -0,0 +1,190 @@
+//
+// SCAN.cpp
+//
+// implements vectorized scanning helpers for the lexer
+//
+
+#include "scan.hpp"
+
+#include "../snippets.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define CSTC_SCAN_X86
+    #include <immintrin.h>
+#endif
+
+namespace lexer {
+    namespace scan {
+        inline bool isIdent(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+        //
+        // scalar
+        //
+
+        uint64 findScalar(std::string_view text, uint64 from, char a, char b, char c) {
+            if (a == b && b == c) {
+                if (from >= text.size()) return text.size();
+                const void* p = std::memchr(text.data() + from, a, text.size() - from);
+                return p == nullptr ? text.size() : (const char*) p - text.data();
+            }
+            while (from < text.size() && text[from] != a && text[from] != b && text[from] != c) from++;
+            return from;
+        }
+
+        uint64 skipIdentScalar(std::string_view text, uint64 from) {
+            while (from < text.size() && isIdent(text[from])) from++;
+            return from;
+        }
+
+        uint64 skipBlankScalar(std::string_view text, uint64 from) {
+            while (from < text.size() && isBlank(text[from])) from++;
+            return from;
+        }
+
+#ifdef CSTC_SCAN_X86
+        //
+        // SSE2 (always available on x86_64)
+        //
+
+        /**
+         * @brief mask of all bytes of x in [lo, hi] (unsigned)
+         */
+        inline __m128i inRange128(__m128i x, char lo, char hi) {
+            __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+            return _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8((char) (hi - lo))), _mm_setzero_si128());
+        }
+
+        uint64 findSSE2(std::string_view text, uint64 from, char a, char b, char c) {
+            const char*   p  = text.data();
+            const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+            for (; from + 16 <= text.size(); from += 16) {
+                __m128i x = _mm_loadu_si128((const __m128i*) (p + from));
+                __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb)), _mm_cmpeq_epi8(x, vc));
+                uint32  bits = _mm_movemask_epi8(m);
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return findScalar(text, from, a, b, c);
+        }
+
+        uint64 skipIdentSSE2(std::string_view text, uint64 from) {
+            const char*   p          = text.data();
+            const __m128i underscore = _mm_set1_epi8('_');
+            const __m128i lower      = _mm_set1_epi8(0x20);
+            for (; from + 16 <= text.size(); from += 16) {
+                __m128i x     = _mm_loadu_si128((const __m128i*) (p + from));
+                __m128i alpha = inRange128(_mm_or_si128(x, lower), 'a', 'z');
+                __m128i digit = inRange128(x, '0', '9');
+                __m128i m     = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(x, underscore));
+                uint32  bits  = ~_mm_movemask_epi8(m) & 0xFFFF;
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return skipIdentScalar(text, from);
+        }
+
+        uint64 skipBlankSSE2(std::string_view text, uint64 from) {
+            const char*   p     = text.data();
+            const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+            for (; from + 16 <= text.size(); from += 16) {
+                __m128i x    = _mm_loadu_si128((const __m128i*) (p + from));
+                __m128i m    = _mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab));
+                uint32  bits = ~_mm_movemask_epi8(m) & 0xFFFF;
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return skipBlankScalar(text, from);
+        }
+
+        //
+        // AVX2 (compiled for the target only, chosen at runtime)
+        //
+
+        #define AVX2 __attribute__((target("avx2")))
+
+        AVX2 inline __m256i inRange256(__m256i x, char lo, char hi) {
+            __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+            return _mm256_cmpeq_epi8(_mm256_subs_epu8(shifted, _mm256_set1_epi8((char) (hi - lo))),
+                                     _mm256_setzero_si256());
+        }
+
+        AVX2 uint64 findAVX2(std::string_view text, uint64 from, char a, char b, char c) {
+            const char*   p  = text.data();
+            const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+            for (; from + 32 <= text.size(); from += 32) {
+                __m256i x = _mm256_loadu_si256((const __m256i*) (p + from));
+                __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, va), _mm256_cmpeq_epi8(x, vb)),
+                                            _mm256_cmpeq_epi8(x, vc));
+                uint32  bits = _mm256_movemask_epi8(m);
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return findSSE2(text, from, a, b, c);
+        }
+
+        AVX2 uint64 skipIdentAVX2(std::string_view text, uint64 from) {
+            const char*   p          = text.data();
+            const __m256i underscore = _mm256_set1_epi8('_');
+            const __m256i lower      = _mm256_set1_epi8(0x20);
+            for (; from + 32 <= text.size(); from += 32) {
+                __m256i x     = _mm256_loadu_si256((const __m256i*) (p + from));
+                __m256i alpha = inRange256(_mm256_or_si256(x, lower), 'a', 'z');
+                __m256i digit = inRange256(x, '0', '9');
+                __m256i m     = _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(x, underscore));
+                uint32  bits  = ~(uint32) _mm256_movemask_epi8(m);
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return skipIdentSSE2(text, from);
+        }
+
+        AVX2 uint64 skipBlankAVX2(std::string_view text, uint64 from) {
+            const char*   p     = text.data();
+            const __m256i space = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+            for (; from + 32 <= text.size(); from += 32) {
+                __m256i x    = _mm256_loadu_si256((const __m256i*) (p + from));
+                __m256i m    = _mm256_or_si256(_mm256_cmpeq_epi8(x, space), _mm256_cmpeq_epi8(x, tab));
+                uint32  bits = ~(uint32) _mm256_movemask_epi8(m);
+                if (bits != 0) return from + __builtin_ctz(bits);
+            }
+            return skipBlankSSE2(text, from);
+        }
+
+        #undef AVX2
+#endif
+
+        const Scanner scalar = {findScalar, skipIdentScalar, skipBlankScalar, "scalar"};
+#ifdef CSTC_SCAN_X86
+        const Scanner sse2 = {findSSE2, skipIdentSSE2, skipBlankSSE2, "sse2"};
+        const Scanner avx2 = {findAVX2, skipIdentAVX2, skipBlankAVX2, "avx2"};
+#endif
+
+        /**
+         * @brief choose the Scanner to use
+         */
+        const Scanner& choose() {
+            const char* forced = std::getenv("CSTC_SCAN");
+            String      want   = forced == nullptr ? "" : forced;
+            if (want == "scalar") return scalar;
+#ifdef CSTC_SCAN_X86
+            if (want == "sse2") return sse2;
+            if (__builtin_cpu_supports("avx2")) return avx2;
+            return sse2;
+#else
+            return scalar;
+#endif
+        }
+    } // namespace scan
+} // namespace lexer
+
+/**
+ * @brief get the best Scanner supported by this CPU. The choice can be overridden with the
+ * CSTC_SCAN environment variable (avx2, sse2 or scalar), e.g. for benchmarking.
+ */
+const lexer::scan::Scanner& lexer::scan::scanner() {
+    static const Scanner& chosen = choose();
+    return chosen;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+//
+// SCAN.hpp
+//
+// layouts vectorized scanning helpers for the lexer
+//
+
+#include "../snippets.h"
+
+#include <string_view>
+
+namespace lexer {
+    namespace scan {
+        /**
+         * @brief a set of scanning functions. Which implementation is used is chosen at runtime,
+         * @see lexer::scan::scanner
+         */
+        struct Scanner {
+                /**
+                 * @brief find the first occurence of a, b or c in text at or after from
+                 *
+                 * @return its index or text.size() if there is none
+                 */
+                uint64 (*find)(std::string_view text, uint64 from, char a, char b, char c);
+
+                /**
+                 * @brief skip a run of [A-Za-z0-9_] starting at from
+                 *
+                 * @return index of the first char that is not part of the run
+                 */
+                uint64 (*skipIdent)(std::string_view text, uint64 from);
+
+                /**
+                 * @brief skip a run of spaces and tabs starting at from
+                 *
+                 * @return index of the first char that is not part of the run
+                 */
+                uint64 (*skipBlank)(std::string_view text, uint64 from);
+
+                const char* name; //> implementation name ("avx2", "sse2" or "scalar")
+        };
+
+        /**
+         * @brief get the best Scanner supported by this CPU. The choice can be overridden with the
+         * CSTC_SCAN environment variable (avx2, sse2 or scalar), e.g. for benchmarking.
+         */
+        extern const Scanner& scanner();
+    } // namespace scan
+} // namespace lexer
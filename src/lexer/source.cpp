@@ -0,0 +1,151 @@
+//
+// SOURCE.cpp
+//
+// implements the Source and SourceManager classes
+//
+
+#include "source.hpp"
+
+#include "../snippets.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define CSTC_HAS_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+    #include <iterator>
+#endif
+
+lexer::SourceManager lexer::sources; //> all source files of this compilation
+
+lexer::Source::Source(FileId id, String filename, String contents) :
+    owned(std::move(contents)), id(id), filename(std::move(filename)), text(owned) {}
+
+lexer::Source::Source(FileId id, String filename, const char* mapping, uint64 length) :
+    mapping(mapping), id(id), filename(std::move(filename)), text(mapping, length) {}
+
+lexer::Source::~Source() {
+#ifdef CSTC_HAS_MMAP
+    if (mapping != nullptr) { munmap((void*) mapping, text.size()); }
+#endif
+}
+
+/**
+ * @brief keep a String alive for as long as this Source lives. Used for token contents
+ * that are not a contiguous part of the text.
+ *
+ * @return a view of the kept String
+ */
+std::string_view lexer::Source::keep(String s) {
+    std::lock_guard<std::mutex> lock(kept_lock);
+    kept.push_back(s);
+    return kept.back();
+}
+
+/**
+ * @brief get the contents of a line (without the line break). The line start table is only
+ * built when this is first called, i.e. when a diagnostic needs it.
+ *
+ * @param l line number, starting at 1
+ *
+ * @return view of the line or "" if l is out of range
+ */
+std::string_view lexer::Source::line(uint64 l) {
+    std::call_once(lines_found, [this] {
+        line_starts.push_back(0);
+        const char* begin = text.data();
+        const char* end   = begin + text.size();
+        for (const char* p = begin; (p = (const char*) std::memchr(p, '\n', end - p)) != nullptr; p++) {
+            line_starts.push_back(p - begin + 1);
+        }
+    });
+    if (l == 0 || l > line_starts.size()) return "";
+
+    uint64 start = line_starts[l - 1];
+    uint64 stop  = l < line_starts.size() ? line_starts[l] - 1 : text.size();
+    return std::string_view(text).substr(start, stop - start);
+}
+
+/**
+ * @brief attach the decoded values of all literal tokens in the text. Done by the lexer.
+ *
+ * @param literals values by the offset of their tokens, in order of the offsets
+ */
+void lexer::Source::setLiterals(std::vector<std::pair<uint64, Literal>> literals) {
+    this->literals = std::move(literals);
+}
+
+/**
+ * @brief get the decoded value of the literal token at offset
+ *
+ * @return the value or a Literal of kind NONE if the lexer found no literal there
+ */
+lexer::Literal lexer::Source::literal(uint64 offset) const {
+    auto it = std::lower_bound(literals.begin(), literals.end(), offset, [](const auto& l, uint64 o) {
+        return l.first < o;
+    });
+    return it != literals.end() && it->first == offset ? it->second : Literal();
+}
+
+/**
+ * @brief register a new file
+ *
+ * @return the Source created. References stay valid for the lifetime of the SourceManager
+ */
+lexer::Source& lexer::SourceManager::add(String filename, String text) {
+    files.emplace_back(files.size(), std::move(filename), std::move(text));
+    return files.back();
+}
+
+/**
+ * @brief register a file from disk. The file is mapped read-only if possible (falling back
+ * to read()), so its contents are neither copied nor held twice next to the page cache.
+ * A file that can not be opened is registered with empty contents.
+ *
+ * @return the Source created. References stay valid for the lifetime of the SourceManager
+ */
+lexer::Source& lexer::SourceManager::load(String filename) {
+#ifdef CSTC_HAS_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) { return add(filename, ""); }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+            close(fd);
+            madvise(m, st.st_size, MADV_SEQUENTIAL);
+            files.emplace_back(files.size(), std::move(filename), (const char*) m, (uint64) st.st_size);
+            return files.back();
+        }
+    }
+
+    // fallback: buffered read()
+    String  text;
+    char    buffer[1 << 16];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) { text.append(buffer, n); }
+    close(fd);
+    return add(filename, std::move(text));
+#else
+    std::ifstream f(filename, std::ios::binary);
+    String        text((std::istreambuf_iterator<char>(f)), (std::istreambuf_iterator<char>()));
+    return add(filename, std::move(text));
+#endif
+}
+
+/**
+ * @brief get a file by its id
+ */
+lexer::Source& lexer::SourceManager::operator[](FileId id) {
+    return files.at(id);
+}
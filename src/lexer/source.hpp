@@ -0,0 +1,149 @@
+#pragma once
+
+//
+// SOURCE.hpp
+//
+// layouts the Source and SourceManager classes
+//
+
+#include "../snippets.h"
+
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lexer {
+    typedef uint32 FileId; //> index of a Source in the SourceManager
+
+    constexpr FileId NO_FILE = UINT32_MAX; //> FileId of tokens that do not belong to any file
+
+    class TokenStore;
+
+    /**
+     * @struct Literal the value of an INT, HEX, BINARY, FLOAT or CHAR token, decoded once by the lexer
+     */
+    struct Literal {
+            enum Kind : uint8 {
+                NONE,      //> not a literal
+                INTEGER,   //> INT, HEX, BINARY
+                FLOATING,  //> FLOAT
+                CODEPOINT, //> CHAR
+            };
+
+            Kind    kind       = NONE;
+            bool    overflow   = false; //> INTEGER: the value does not fit 64 bits, integer holds the lower bits
+            bool    escape     = false; //> CODEPOINT: the char is written as an escape sequence
+            bool    valid      = false; //> CODEPOINT: the literal holds exactly one char or a supported escape
+            uint32  code_point = 0;     //> CODEPOINT: the char's value
+            uint64  integer    = 0;     //> INTEGER: the value
+            float80 floating   = 0;     //> FLOATING: the value
+    };
+
+    /**
+     * @class Source owns the text of a source file. Tokens only refer to it using string_views,
+     * so a Source has to outlive all of the tokens created from it.
+     */
+    class Source final : public Repr {
+        protected:
+            String _str() const { return "Source "s + filename; }
+
+        private:
+            String      owned   = "";      //> the contents, if they are not mapped
+            const char* mapping = nullptr; //> start of the file mapping (if any)
+
+        public:
+            const FileId           id;       //> this file's id in the SourceManager
+            const String           filename; //> the file's name (for error messages)
+            const std::string_view text;     //> the file's contents. Either a read-only file mapping or owned
+
+            sptr<const TokenStore> tokens = nullptr; //> the file's tokens once it was tokenized (@see SourceRange)
+
+            Source(FileId id, String filename, String contents);
+            Source(FileId id, String filename, const char* mapping, uint64 length);
+            Source(const Source&)            = delete;
+            Source& operator=(const Source&) = delete;
+            ~Source();
+
+            /**
+             * @brief keep a String alive for as long as this Source lives. Used for token contents
+             * that are not a contiguous part of the text. Thread-safe.
+             *
+             * @return a view of the kept String
+             */
+            std::string_view keep(String s);
+
+            /**
+             * @brief get the contents of a line (without the line break). The line start table is only
+             * built when this is first called, i.e. when a diagnostic needs it.
+             *
+             * @param l line number, starting at 1
+             *
+             * @return view of the line or "" if l is out of range
+             */
+            std::string_view line(uint64 l);
+
+            /**
+             * @brief attach the decoded values of all literal tokens in the text. Done by the lexer.
+             *
+             * @param literals values by the offset of their tokens, in order of the offsets
+             */
+            void setLiterals(std::vector<std::pair<uint64, Literal>> literals);
+
+            /**
+             * @brief get the decoded value of the literal token at offset
+             *
+             * @return the value or a Literal of kind NONE if the lexer found no literal there
+             */
+            Literal literal(uint64 offset) const;
+
+        private:
+            std::deque<String>  kept        = {}; //> deque, so views stay valid on insertion
+            std::mutex          kept_lock;        //> keep() may be called by several lexer threads
+            std::vector<uint64> line_starts = {}; //> offsets of all line starts. empty until required
+            std::once_flag      lines_found;      //> line() may be called by several parser threads
+
+            std::vector<std::pair<uint64, Literal>> literals = {}; //> decoded literal values by offset
+    };
+
+    /**
+     * @class SourceManager holds all Sources of a compilation and hands out FileIds for them
+     */
+    class SourceManager final : public Repr {
+        protected:
+            String _str() const { return "SourceManager ("s + std::to_string(files.size()) + " files)"; }
+
+        public:
+            SourceManager()  = default;
+            ~SourceManager() = default;
+
+            /**
+             * @brief register a new file
+             *
+             * @return the Source created. References stay valid for the lifetime of the SourceManager
+             */
+            Source& add(String filename, String text);
+
+            /**
+             * @brief register a file from disk. The file is mapped read-only if possible (falling back
+             * to read()), so its contents are neither copied nor held twice next to the page cache.
+             * A file that can not be opened is registered with empty contents.
+             *
+             * @return the Source created. References stay valid for the lifetime of the SourceManager
+             */
+            Source& load(String filename);
+
+            /**
+             * @brief get a file by its id
+             */
+            Source& operator[](FileId id);
+
+            inline uint64 size() const noexcept { return files.size(); }
+
+        private:
+            std::deque<Source> files = {}; //> deque, so references stay valid on insertion
+    };
+
+    extern SourceManager sources; //> all source files of this compilation
+} // namespace lexer
@@ -9,10 +9,13 @@
 
 #include "../snippets.h"
 #include "errors.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <initializer_list>
-#include <stack>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -116,39 +119,248 @@ String lexer::getTokenName(lexer::Token::Type type) {
 }
 
 String lexer::Token::_str() const {
-    return "Token "s + getTokenName(type) + "\t\"" + fillup(value + "\"", 30) + " @ " + std::to_string(l) + ":" + std::to_string(c);
+    return "Token "s + getTokenName(type) + "\t\"" + fillup(String(value) + "\"", 30) + " @ " + std::to_string(l) + ":" + std::to_string(c);
 }
 
-lexer::Token::Token(lexer::Token::Type t, String content, uint64 l, uint64 c, String filename, sptr<String> lc){
+lexer::Token::Token(lexer::Token::Type t, std::string_view content, uint64 l, uint64 c, FileId file, uint64 offset){
     type = t;
     this->l = l; this->c = c;
-    this->filename = filename;
+    this->file = file;
+    this->offset = offset;
     this->value = content;
-    this->line_contents = lc;
 }
 
 lexer::Token::~Token() = default;
 
 bool lexer::Token::operator==(Token other) { return type == other.type && value == other.value; }
 
+std::string_view lexer::Token::filename() const {
+    return file == NO_FILE ? "" : std::string_view(sources[file].filename);
+}
+
+std::string_view lexer::Token::lineContents() const {
+    return file == NO_FILE ? "" : sources[file].line(l);
+}
+
+
+void lexer::TokenStore::push_back(const Token& t) {
+    bool fits = t.file != NO_FILE && t.l <= UINT32_MAX && t.c <= UINT32_MAX && t.value.size() < COLD;
+    if (fits) { // the contents have to be the part of the File's text the token points to
+        std::string_view text = sources[t.file].text;
+        fits                  = t.offset <= text.size() && t.value.data() == text.data() + t.offset;
+    }
+    types.push_back(t.type);
+    if (fits) {
+        positions.push_back({(uint32) t.l, (uint32) t.c});
+        texts.push_back({t.file, (uint32) t.value.size(), t.offset});
+    } else {
+        positions.push_back({0, 0});
+        texts.push_back({t.file, COLD, 0});
+        cold.push_back({types.size() - 1, t});
+    }
+}
+
+void lexer::TokenStore::append(const TokenStore& other, uint64 from, uint64 to) {
+    uint64 shift = size();
+    types.insert(types.end(), other.types.begin() + from, other.types.begin() + to);
+    positions.insert(positions.end(), other.positions.begin() + from, other.positions.begin() + to);
+    texts.insert(texts.end(), other.texts.begin() + from, other.texts.begin() + to);
+
+    auto first = std::lower_bound(other.cold.begin(), other.cold.end(), from, [](const auto& c, uint64 i) {
+        return c.first < i;
+    });
+    for (auto it = first; it != other.cold.end() && it->first < to; it++) {
+        cold.push_back({it->first - from + shift, it->second});
+    }
+}
+
+lexer::Token lexer::TokenStore::at(uint64 idx) const {
+    const Text& x = texts[idx];
+    if (x.size == COLD) {
+        return std::lower_bound(cold.begin(), cold.end(), idx, [](const auto& c, uint64 i) { return c.first < i; })
+            ->second;
+    }
+    return Token(types[idx],
+                 sources[x.file].text.substr(x.offset, x.size),
+                 positions[idx].l,
+                 positions[idx].c,
+                 x.file,
+                 x.offset);
+}
+
+lexer::Literal lexer::TokenStore::literal(uint64 idx) const {
+    const Text& x = texts[idx];
+    if (x.size != COLD) {
+        Literal l = sources[x.file].literal(x.offset);
+        if (l.kind != Literal::NONE) return l;
+    }
+    return decode(types[idx], at(idx).value); // a token that was not lexed from its File's text
+}
+
+uint64 lexer::TokenStore::find(uint64 offset) const {
+    auto at_offset = [&](uint64 idx) { return texts[idx].size == COLD ? at(idx).offset : texts[idx].offset; };
+
+    uint64 lo = 0, hi = size();
+    while (lo < hi) {
+        uint64 mid = lo + (hi - lo) / 2;
+        if (at_offset(mid) < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < size() && at_offset(lo) == offset ? lo : size();
+}
+
+void lexer::TokenStore::reserve(uint64 n) {
+    types.reserve(n);
+    positions.reserve(n);
+    texts.reserve(n);
+}
+
+/**
+ * @brief append the raw bytes of a value to out
+ */
+template <typename T>
+static void put(String& out, const T& value) {
+    out.append((const char*) &value, sizeof(T));
+}
+
+/**
+ * @brief read the raw bytes of n values from the start of in and advance it
+ *
+ * @return false if in is too short
+ */
+template <typename T>
+static bool take(std::string_view& in, T* values, uint64 n = 1) {
+    if (in.size() / sizeof(T) < n) return false;
+    std::memcpy((void*) values, in.data(), n * sizeof(T));
+    in.remove_prefix(n * sizeof(T));
+    return true;
+}
+
+void lexer::TokenStore::serialize(String& out) const {
+    put(out, (uint64) size());
+    put(out, (uint64) cold.size());
+    out.append((const char*) types.data(), types.size() * sizeof(Token::Type));
+    out.append((const char*) positions.data(), positions.size() * sizeof(Position));
+    out.append((const char*) texts.data(), texts.size() * sizeof(Text));
+    for (const auto& [idx, t] : cold) {
+        put(out, idx);
+        put(out, t.type);
+        put(out, t.l);
+        put(out, t.c);
+        put(out, t.offset);
+        put(out, (uint8) (t.file != NO_FILE));
+        put(out, (uint64) t.value.size());
+        out.append(t.value);
+    }
+}
+
+bool lexer::TokenStore::deserialize(std::string_view& in, Source& file) {
+    uint64 n, n_cold;
+    if (!take(in, &n) || !take(in, &n_cold)) return false;
+    if (in.size() / (sizeof(Token::Type) + sizeof(Position) + sizeof(Text)) < n) return false;
+
+    types.resize(n);
+    positions.resize(n);
+    texts.resize(n);
+    take(in, types.data(), n);
+    take(in, positions.data(), n);
+    take(in, texts.data(), n);
+    for (Token::Type t : types) {
+        if (t > Token::X) return false;
+    }
+    for (Text& x : texts) {
+        if (x.size != COLD && (x.offset > file.text.size() || file.text.size() - x.offset < x.size)) return false;
+        x.file = file.id;
+    }
+
+    cold.clear();
+    for (uint64 i = 0; i < n_cold; i++) {
+        Token  t;
+        uint64 idx, size;
+        uint8  in_file;
+        if (!take(in, &idx) || !take(in, &t.type) || !take(in, &t.l) || !take(in, &t.c) || !take(in, &t.offset) ||
+            !take(in, &in_file) || !take(in, &size) || in.size() < size || idx >= n || t.type > Token::X) {
+            return false;
+        }
+        t.file  = in_file ? file.id : NO_FILE;
+        t.value = file.keep(String(in.substr(0, size)));
+        in.remove_prefix(size);
+        cold.push_back({idx, t});
+    }
+    return true;
+}
+
+lexer::TokenStream lexer::TokenStream::of(TokenStore store) {
+    TokenStream t({});
+    store.matchBrackets();
+    t.last  = store.size();
+    t.store = share<const TokenStore>(new TokenStore(std::move(store)));
+    return t;
+}
+
+lexer::TokenStream::TokenStream(const std::vector<Token>& tokens) {
+    static const sptr<const TokenStore> empty = share<const TokenStore>(new TokenStore());
+    if (tokens.empty()) { // empty streams are created all the time, they all share one store
+        store = empty;
+        return;
+    }
+    sptr<TokenStore> s = share<TokenStore>(new TokenStore());
+    s->reserve(tokens.size());
+    for (const Token& t : tokens) s->push_back(t);
+    s->matchBrackets();
+    store = s;
+    last  = tokens.size();
+}
+
+std::vector<lexer::Token> lexer::TokenStream::list() const {
+    std::vector<Token> out;
+    out.reserve(size());
+    for (uint64 i = first; i < last; i++) out.push_back(store->at(i));
+    return out;
+}
+
+void lexer::TokenStream::serialize(String& out) const {
+    if (first == 0 && last == store->size()) {
+        store->serialize(out);
+        return;
+    }
+    TokenStore part;
+    part.append(*store, first, last);
+    part.serialize(out);
+}
+
+void lexer::TokenStream::attachTo(Source& file) const {
+    file.tokens = store;
+}
 
 lexer::TokenStream lexer::TokenStream::slice(int64 start, int64 step, int64 stop) const {
-    std::vector<Token> t;
     if (start < 0)
         start += size();
     if (stop < 0)
         stop += size();
     bool d = start > stop;
+    if (step == 1 && !d) { // the usual case: a view of the same store
+        if (start < 0 || stop > (int64) size()) throw std::out_of_range("TokenStream slice out of range");
+        TokenStream t = *this;
+        t.first       = first + start;
+        t.last        = first + stop;
+        return t;
+    }
+    TokenStore part;
     for (int64 i = start; d ? i > stop : i < stop; i += step) {
-        t.push_back(tokens.at(i));
+        if (i < 0 || i >= (int64) size()) throw std::out_of_range("TokenStream slice out of range");
+        part.append(*store, first + i, first + i + 1);
     }
-    return TokenStream(t);
+    return of(std::move(part));
 }
 
 lexer::TokenStream::Match lexer::TokenStream::split(std::initializer_list<Token::Type> a, uint64 start_idx) const {
+    const Token::Type* types = store->typeData() + first;
     for (uint64 i = start_idx; i < size(); i++) {
-        Token t = tokens.at(i);
-        if (std::find(a.begin(), a.end(), t.type) != a.end()) {
+        if (std::find(a.begin(), a.end(), types[i]) != a.end()) {
             return TokenStream::Match(i, true, this);
         }
     }
@@ -157,91 +369,132 @@ lexer::TokenStream::Match lexer::TokenStream::split(std::initializer_list<Token:
 
 
 lexer::TokenStream::Match lexer::TokenStream::rsplit(std::initializer_list<Token::Type> a, uint64 start_idx) const {
+    const Token::Type* types = store->typeData() + first;
+    if (start_idx > size()) throw std::out_of_range("TokenStream rsplit start out of range");
     for (uint64 i = size() - start_idx; i > 0; i--) {
-        Token t = tokens.at(i-1);
-        if (std::find(a.begin(), a.end(), t.type) != a.end()) {
+        if (std::find(a.begin(), a.end(), types[i-1]) != a.end()) {
             return TokenStream::Match(i-1, true, this);
         }
     }
     return TokenStream::Match(0, false, this);
 }
 
-lexer::TokenStream::Match lexer::TokenStream::splitStack(std::initializer_list<Token::Type> delimiter, uint64 start_idx) const {
-    std::stack<lexer::Token> s = {};
-    const std::vector<Token>& t = tokens;
-
-    int64 i;
-    for(i=t.size()-1-start_idx; i>=0 ; i--){
-        if (t[i].type == lexer::Token::Type::CLOSE || t[i].type == lexer::Token::Type::INDEX_CLOSE || t[i].type == lexer::Token::Type::BLOCK_CLOSE) {
-            if (s.size() == 0 && std::find(delimiter.begin(), delimiter.end(), t[i].type) != delimiter.end())
-                return TokenStream::Match(i, true, this);
-            s.push(t[i]);
-        }
+namespace lexer {
+    inline bool isOpening(Token::Type t) {
+        return t == Token::Type::OPEN || t == Token::Type::INDEX_OPEN || t == Token::Type::BLOCK_OPEN;
+    }
 
-        else if (t[i].type == lexer::Token::Type::OPEN){
-            if(s.size() == 0) lexer::error("Unclosed OPEN", {t[i]}, "This OPEN was not closed" , 46);
-            if(s.top().type != lexer::Token::Type::CLOSE) lexer::error("Unopened "s + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not opened" , 47);
-            s.pop();
-        }
+    inline bool isClosing(Token::Type t) {
+        return t == Token::Type::CLOSE || t == Token::Type::INDEX_CLOSE || t == Token::Type::BLOCK_CLOSE;
+    }
 
-        else if (t[i].type == lexer::Token::Type::INDEX_OPEN){
-            if(s.size() == 0) lexer::error("Unclosed INDEX", {t[i]}, "This INDEX was not closed" , 46);
-            if(s.top().type != lexer::Token::Type::INDEX_CLOSE) lexer::error("Unopened "s + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not opened" , 47);
-            s.pop();
-        }
+    /**
+     * @brief get a bracket's kind: 0 for (), 1 for [] and 2 for {}
+     */
+    inline uint8 bracketKind(Token::Type t) {
+        if (t == Token::Type::OPEN || t == Token::Type::CLOSE) return 0;
+        if (t == Token::Type::INDEX_OPEN || t == Token::Type::INDEX_CLOSE) return 1;
+        return 2;
+    }
+} // namespace lexer
 
-        else if (t[i].type == lexer::Token::Type::BLOCK_OPEN){
-            if(s.size() == 0) lexer::error("Unclosed BLOCK", {t[i]}, "This BLOCK was not closed" , 46);
-            if(s.top().type != lexer::Token::Type::BLOCK_CLOSE) lexer::error("Unopened "s + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not opened" , 47);
-            s.pop();
+void lexer::TokenStore::matchBrackets() {
+    partners.assign(size(), UNMATCHED);
+    std::vector<uint32> open           = {};        //> indices of the brackets not closed yet
+    uint64              open_by_kind[] = {0, 0, 0}; //> number of open (, [ and {
+    for (uint64 i = 0; i < size(); i++) {
+        if (isOpening(types[i])) {
+            open.push_back(i);
+            open_by_kind[bracketKind(types[i])]++;
+        } else if (isClosing(types[i]) && open_by_kind[bracketKind(types[i])] > 0) {
+            // brackets opened inside of this one that are still open stay unmatched
+            while (bracketKind(types[open.back()]) != bracketKind(types[i])) {
+                open_by_kind[bracketKind(types[open.back()])]--;
+                open.pop_back();
+            }
+            partners[i]           = open.back();
+            partners[open.back()] = i;
+            open_by_kind[bracketKind(types[i])]--;
+            open.pop_back();
         }
-        if (s.size() == 0 && std::find(delimiter.begin(), delimiter.end(), t[i].type) != delimiter.end())
-            return TokenStream::Match(i, true, this);
-    
     }
-    for(uint64 j=0; j<s.size(); j++){
-        lexer::error("Unopened " + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not opened" , 47);
-        s.pop();
-    }
-    return TokenStream::Match(0, false, this);
 }
 
-lexer::TokenStream::Match lexer::TokenStream::rsplitStack(std::initializer_list<Token::Type> delimiter, uint64 start_idx) const {
-    std::stack<lexer::Token> s = {};
-    const std::vector<Token>& t = tokens;
-
-    uint64 i;
-    for(i=start_idx; i<t.size(); i++){
-        if (t[i].type == lexer::Token::Type::OPEN || t[i].type == lexer::Token::Type::INDEX_OPEN || t[i].type == lexer::Token::Type::BLOCK_OPEN) {
-            if (s.size() == 0 && std::find(delimiter.begin(), delimiter.end(), t[i].type) != delimiter.end())
-                return TokenStream::Match(i, true, this);
-            s.push(t[i]);
+void lexer::TokenStream::checkBrackets() const {
+    const Token::Type* t = store->typeData();
+    for (uint64 i = first; i < last; i++) {
+        uint64 p = store->partner(i);
+        if (isClosing(t[i]) && (p == TokenStore::UNMATCHED || p < first)) {
+            String name = t[i] == Token::Type::CLOSE ? "PARANTHESIS" : t[i] == Token::Type::INDEX_CLOSE ? "INDEX" : "BLOCK";
+            lexer::error("Unopened "s + name, {store->at(i)}, "This " + name + " was not opened", 46);
+        } else if (isOpening(t[i]) && (p == TokenStore::UNMATCHED || p >= last)) {
+            lexer::error("Unclosed " + getTokenName(t[i]), {store->at(i)}, "This " + getTokenName(t[i]) + " was not closed", 47);
         }
+    }
+}
 
-        else if (t[i].type == lexer::Token::Type::CLOSE){
-            if(s.size() == 0) lexer::error("Unopened PARANTHESIS", {t[i]}, "This PARANTHESIS was not opened" , 46);
-            if(s.top().type != lexer::Token::Type::OPEN) lexer::error("Unclosed " + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not closed" , 47);
-            s.pop();
-        }
+lexer::TokenStream::Match lexer::TokenStream::splitStack(std::initializer_list<Token::Type> delimiter, uint64 start_idx) const {
+    const Token::Type* t = store->typeData() + first;
+    auto delimits = [&](int64 i) { return std::find(delimiter.begin(), delimiter.end(), t[i]) != delimiter.end(); };
 
-        else if (t[i].type == lexer::Token::Type::INDEX_CLOSE){
-            if(s.size() == 0) lexer::error("Unopened INDEX", {t[i]}, "This INDEX was not opened" , 46);
-            if(s.top().type != lexer::Token::Type::INDEX_OPEN) lexer::error("Unclosed " + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not closed" , 47);
-            s.pop();
+    for (int64 i = size() - 1 - start_idx; i >= 0; i--) {
+        if (delimits(i)) return TokenStream::Match(i, true, this);
+        if (isClosing(t[i])) { // skip to the opening bracket. If it is not in this stream, nothing before is outside of brackets
+            uint64 p = store->partner(first + i);
+            if (p == TokenStore::UNMATCHED || p < first) break;
+            i = p - first;
+            if (delimits(i)) return TokenStream::Match(i, true, this);
         }
+    }
+    return TokenStream::Match(0, false, this);
+}
 
-        else if (t[i].type == lexer::Token::Type::BLOCK_CLOSE){
-            if(s.size() == 0) lexer::error("Unopened BLOCK", {t[i]}, "This BLOCK was not opened" , 46);
-            if(s.top().type != lexer::Token::Type::BLOCK_OPEN) lexer::error("Unclosed " + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not closed" , 47);
-            s.pop();
+lexer::TokenStream::Match lexer::TokenStream::rsplitStack(std::initializer_list<Token::Type> delimiter, uint64 start_idx) const {
+    const Token::Type* t = store->typeData() + first;
+    auto delimits = [&](uint64 i) { return std::find(delimiter.begin(), delimiter.end(), t[i]) != delimiter.end(); };
+
+    for (uint64 i = start_idx; i < size(); i++) {
+        if (delimits(i)) return TokenStream::Match(i, true, this);
+        if (isOpening(t[i])) { // skip to the closing bracket. If it is not in this stream, nothing after is outside of brackets
+            uint64 p = store->partner(first + i);
+            if (p == TokenStore::UNMATCHED || p >= last) break;
+            i = p - first;
+            if (delimits(i)) return TokenStream::Match(i, true, this);
         }
-        if (s.size() == 0 && std::find(delimiter.begin(), delimiter.end(), t[i].type) != delimiter.end())
-            return TokenStream::Match(i, true, this);
-    
-    }
-    for(uint64 j=0; j<s.size(); j++){
-        lexer::error("Unclosed " + getTokenName(s.top().type), {s.top()}, "This " + getTokenName(s.top().type) + " was not closed" , 47);
-        s.pop();
     }
     return TokenStream::Match(0, false, this);
-}
\ No newline at end of file
+}
+
+lexer::SourceRange::SourceRange(const TokenStream& tokens) {
+    if (tokens.empty()) return;
+    FileId in = tokens.store->file(tokens.first);
+    if (in == NO_FILE) return;
+    const sptr<const TokenStore>& all = sources[in].tokens;
+    if (all == nullptr) return;
+    if (all == tokens.store) { // the usual case: a view of the File's tokens
+        file  = in;
+        first = tokens.first;
+        last  = tokens.last;
+        return;
+    }
+    uint64 a = all->find(tokens.store->at(tokens.first).offset);
+    uint64 b = all->find(tokens.store->at(tokens.last - 1).offset);
+    if (a == all->size() || b == all->size() || b < a) return;
+    file  = in;
+    first = a;
+    last  = b + 1;
+}
+
+lexer::SourceRange lexer::SourceRange::span(SourceRange from, SourceRange to) {
+    if (from.empty()) return to;
+    if (to.empty() || to.file != from.file || to.last < from.first) return from;
+    from.last = to.last;
+    return from;
+}
+
+std::vector<lexer::Token> lexer::SourceRange::ends() const {
+    if (empty()) return {};
+    const TokenStore& all = *sources[file].tokens;
+    if (last - first == 1) return {all.at(first)};
+    return {all.at(first), all.at(last - 1)};
+}
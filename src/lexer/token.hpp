@@ -7,8 +7,12 @@
 //
 
 #include "../snippets.h"
+#include "source.hpp"
 
 #include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <string_view>
 #include <vector>
 
 namespace lexer {
@@ -20,7 +24,7 @@ namespace lexer {
             virtual String _str() const;
 
         public:
-            enum Type {
+            enum Type : uint8 {
                 /**
                  * @enum of all available Token types
                  */
@@ -136,18 +140,28 @@ namespace lexer {
                 // clang-format on
             };
 
-            Type   type;  //> this tokens type
-            String value; //> this tokens contents
+            Type             type;  //> this tokens type
+            std::string_view value; //> this tokens contents. Points into the lexer::Source it was created from
 
-            uint64       l, c;          //> this tokens position in the File
-            String       filename;      //> this tokens File's name (for error messages)
-            sptr<String> line_contents; //> this tokens line's contents (for error messages)
+            uint64 l, c;           //> this tokens position in the File
+            FileId file = NO_FILE; //> this tokens File (@see lexer::sources)
+            uint64 offset = 0;     //> this tokens offset in its File's text
 
-            Token(Type t, String content, uint64 l, uint64 c, String filename, sptr<String> lc);
+            Token(Type t, std::string_view content, uint64 l, uint64 c, FileId file, uint64 offset);
             Token() = default;
             virtual ~Token();
 
             bool operator==(Token other);
+
+            /**
+             * @brief get this tokens File's name (for error messages)
+             */
+            std::string_view filename() const;
+
+            /**
+             * @brief get this tokens line's contents (for error messages). Looked up lazily from the Source.
+             */
+            std::string_view lineContents() const;
     };
 
     /**
@@ -155,14 +169,117 @@ namespace lexer {
      */
     String getTokenName(Token::Type);
 
-    class TokenStream final : public Repr {
+    /**
+     * @class TokenStore holds tokens as a structure of arrays. The types, which the parser scans all the time,
+     * are a dense byte array. Positions and text offsets are kept in separate arrays, everything that does not
+     * fit them (contents that are not part of a Source's text, huge positions) in a side table.
+     */
+    class TokenStore final {
         public:
-            std::vector<Token> tokens;
+            struct Position {
+                    uint32 l, c; //> line and column
+            };
+
+            struct Text {
+                    FileId file;   //> File the contents are in
+                    uint32 size;   //> contents' length or COLD if the token is in the side table
+                    uint64 offset; //> contents' offset in the File's text
+            };
+
+            static constexpr uint32 COLD      = UINT32_MAX; //> Text::size of tokens that are kept in the side table
+            static constexpr uint32 UNMATCHED = UINT32_MAX; //> partner of tokens that are no paired bracket
+
+            TokenStore() = default;
+
+            /**
+             * @brief add a token at the end
+             */
+            void push_back(const Token& t);
+
+            /**
+             * @brief add the tokens from (inclusive) to to (exclusive) of other at the end
+             */
+            void append(const TokenStore& other, uint64 from, uint64 to);
+
+            /**
+             * @brief get a token. It is put together from the arrays, so this is a copy
+             */
+            Token at(uint64 idx) const;
+
+            inline Token::Type type(uint64 idx) const { return types[idx]; }
+
+            inline FileId file(uint64 idx) const { return texts[idx].file; }
+
+            /**
+             * @brief find the token starting at offset in its File's text. Tokens have to be in the order of the text
+             *
+             * @return its index or size() if there is none
+             */
+            uint64 find(uint64 offset) const;
+
+            /**
+             * @brief get a token's decoded literal value (@see Source::literal). Its kind is NONE if the token
+             * is no literal
+             */
+            Literal literal(uint64 idx) const;
+
+            inline const Token::Type* typeData() const noexcept { return types.data(); }
+
+            /**
+             * @brief pair up all brackets ((), [] and {}). A closing bracket closes the innermost open one of its
+             * kind, brackets opened inside of it stay unpaired. Has to be called again after adding tokens.
+             */
+            void matchBrackets();
+
+            /**
+             * @brief get the index of the bracket paired with the one at idx or UNMATCHED. @see matchBrackets
+             */
+            inline uint64 partner(uint64 idx) const { return partners[idx]; }
+
+            inline uint64 size() const noexcept { return types.size(); }
+
+            void reserve(uint64 n);
+
+            /**
+             * @brief append the arrays to out in a compact binary format. Tokens in the side table are written
+             * with their contents. All tokens have to be in the same file. @see lexer::cache
+             */
+            void serialize(String& out) const;
+
+            /**
+             * @brief read arrays written by serialize() from the start of in and advance it. The tokens are put into
+             * file, which keeps the side table's contents alive.
+             *
+             * @return false if in does not hold a valid TokenStore for file
+             */
+            bool deserialize(std::string_view& in, Source& file);
+
+        private:
+            std::vector<Token::Type>              types     = {}; //> each token's type
+            std::vector<Position>                 positions = {}; //> each token's position
+            std::vector<Text>                     texts     = {}; //> each token's contents
+            std::vector<std::pair<uint64, Token>> cold      = {}; //> tokens that do not fit the arrays, by index
+            std::vector<uint32>                   partners  = {}; //> each bracket's partner (@see matchBrackets)
+    };
+
+    /**
+     * @class TokenStream is a view of a range of a TokenStore. Copies and contiguous slices share the store,
+     * so they take constant time no matter how many tokens they hold.
+     */
+    class TokenStream final : public Repr {
+            friend struct SourceRange;
+
+            sptr<const TokenStore> store;     //> the tokens this stream is a view of
+            uint64                 first = 0; //> index of this stream's first token in store
+            uint64                 last  = 0; //> index behind this stream's last token in store
 
         protected:
             String _str() const {
                 String s;
-                for (Token t : tokens) { s += t.value + " "; }
+                for (const Token& t : *this) {
+                    s += t.value;
+                    s += " ";
+                }
                 return s;
             }
 
@@ -194,23 +311,120 @@ namespace lexer {
                     operator bool() { return was_found; }
             };
 
-            TokenStream(std::vector<Token> tokens) { this->tokens = tokens; }
+            /**
+             * @class const_iterator iterates over copies of a TokenStream's tokens
+             */
+            class const_iterator final {
+                    const TokenStream* on  = nullptr;
+                    uint64             idx = 0;
 
+                public:
+                    const_iterator(const TokenStream* on, uint64 idx) {
+                        this->on  = on;
+                        this->idx = idx;
+                    }
+
+                    inline Token operator*() const { return on->store->at(on->first + idx); }
+
+                    inline const_iterator& operator++() {
+                        idx++;
+                        return *this;
+                    }
+
+                    inline bool operator!=(const const_iterator& other) const { return idx != other.idx; }
+            };
+
+            TokenStream(const std::vector<Token>& tokens);
+
+            /**
+             * @brief get the tokens from start (inclusive) to stop (exclusive) taking every step-th. Negative
+             * indices count from the end. A slice with step 1 is a view of the same store and takes constant time
+             */
             TokenStream slice(int64 start, int64 step, int64 stop) const;
 
             TokenStream getTS(int64 idx) {
                 if (idx < 0) { idx += size(); }
-                return TokenStream({tokens.at(idx)});
+                return TokenStream(std::vector<Token>{(*this)[idx]});
             }
 
             Token operator[](int64 idx) const {
                 if (idx < 0) { idx += size(); }
-                return tokens.at(idx);
+                if (idx < 0 || (uint64) idx >= size()) { throw std::out_of_range("TokenStream index out of range"); }
+                return store->at(first + idx);
             }
 
-            inline uint64 size() const noexcept { return tokens.size(); }
+            /**
+             * @brief get a token's type without putting the whole token together
+             */
+            Token::Type type(int64 idx) const {
+                if (idx < 0) { idx += size(); }
+                if (idx < 0 || (uint64) idx >= size()) { throw std::out_of_range("TokenStream index out of range"); }
+                return store->type(first + idx);
+            }
+
+            /**
+             * @brief get a token's decoded literal value. @see lexer::Literal
+             */
+            Literal literal(int64 idx) const {
+                if (idx < 0) { idx += size(); }
+                if (idx < 0 || (uint64) idx >= size()) { throw std::out_of_range("TokenStream index out of range"); }
+                return store->literal(first + idx);
+            }
+
+            /**
+             * @brief get the index of the bracket paired with the one at idx. -1 if it is not paired with one in
+             * this stream. @see TokenStore::matchBrackets
+             */
+            int64 partner(int64 idx) const {
+                if (idx < 0) { idx += size(); }
+                if (idx < 0 || (uint64) idx >= size()) { throw std::out_of_range("TokenStream index out of range"); }
+                uint64 p = store->partner(first + idx);
+                if (p == TokenStore::UNMATCHED || p < first || p >= last) { return -1; }
+                return p - first;
+            }
+
+            /**
+             * @brief get copies of all tokens
+             */
+            std::vector<Token> list() const;
+
+            /**
+             * @brief append this stream's tokens to out. @see TokenStore::serialize
+             */
+            void serialize(String& out) const;
+
+            /**
+             * @brief make this stream's store the tokens of file, which SourceRanges in it refer to. Done by the lexer
+             */
+            void attachTo(Source& file) const;
+
+            /**
+             * @brief create a stream from a TokenStore
+             */
+            static TokenStream of(TokenStore store);
+
+            inline const_iterator begin() const { return const_iterator(this, 0); }
 
+            inline const_iterator end() const { return const_iterator(this, size()); }
+
+            inline uint64 size() const noexcept { return last - first; }
+
+            /**
+             * @brief issue errors for all brackets that are not opened or not closed. Done by the lexer, the split
+             * functions rely on it.
+             */
+            void checkBrackets() const;
+
+            /**
+             * @brief find the last token of a type in delimiter that is not inside of brackets, starting start_idx
+             * tokens before the end. Bracketed groups are skipped in constant time.
+             */
             Match splitStack(std::initializer_list<lexer::Token::Type>, uint64 start_idx = 0) const;
+
+            /**
+             * @brief find the first token of a type in delimiter that is not inside of brackets, starting at
+             * start_idx. Bracketed groups are skipped in constant time.
+             */
             Match rsplitStack(std::initializer_list<lexer::Token::Type>, uint64 start_idx = 0) const;
 
             Match split(std::initializer_list<lexer::Token::Type>, uint64 start_idx = 0) const;
@@ -220,8 +434,39 @@ namespace lexer {
 
             inline bool empty() const { return size() == 0; }
     };
+
+    /**
+     * @struct SourceRange is where an AST node or a symbol comes from: a range of the tokens of a File
+     * (@see Source::tokens). It only holds indices, the tokens are put together when a diagnostic is shown.
+     */
+    struct SourceRange {
+            FileId file  = NO_FILE; //> File the tokens are in. NO_FILE if the range could not be found
+            uint32 first = 0;       //> index of the first token in the File's tokens
+            uint32 last  = 0;       //> index behind the last token
+
+            SourceRange() = default;
+
+            /**
+             * @brief get the range a stream's tokens cover. Streams that are not a view of their File's tokens are
+             * looked up by the offsets of their first and last token
+             */
+            SourceRange(const TokenStream& tokens);
+
+            /**
+             * @brief get the range from the start of from to the end of to
+             */
+            static SourceRange span(SourceRange from, SourceRange to);
+
+            inline bool empty() const noexcept { return file == NO_FILE || first == last; }
+
+            /**
+             * @brief get the first and the last token of this range (only one if it holds one), which is all a
+             * diagnostic shows. Empty if the range is
+             */
+            std::vector<Token> ends() const;
+    };
 } // namespace lexer
 
-const lexer::Token nullToken = lexer::Token(lexer::Token::NONE, "", 0, 0, "", nullptr);
+const lexer::Token nullToken = lexer::Token(lexer::Token::NONE, "", 0, 0, lexer::NO_FILE, 0);
 
 
@@ -5,12 +5,15 @@
 //
 
 #include "build/optimizer_flags.hpp"
+#include "lexer/cache.hpp"
 #include "lexer/lexer.hpp"
 #include "module.hpp"
 #include "parser/errors.hpp"
+#include "parser/parser.hpp"
 #include "snippets.h"
 #include "build/targets.hpp"
 #include "../lib/argparse/include/argparse/argparse.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 #include <ostream>
@@ -56,6 +59,28 @@ int32 main(int32 argc, const char** argv){
         .scan<'d', int32>()
         .default_value<int32>(100)
     ;
+    argparser.add_argument("--lex-threads")
+        .help("number of threads for lexing large files (0 for one per CPU core)")
+        .scan<'d', int32>()
+        .default_value<int32>(0)
+    ;
+    argparser.add_argument("-j", "--jobs")
+        .help("number of threads parsing modules and function bodies (0 for one per CPU core)")
+        .scan<'d', int32>()
+        .default_value<int32>(1)
+    ;
+    argparser.add_argument("--no-cache")
+        .help("always tokenize all files instead of using cached tokens")
+        .flag()
+    ;
+    argparser.add_argument("--stats")
+        .help("show how much work the parser did")
+        .flag()
+    ;
+    argparser.add_argument("--cache-dir")
+        .help("directory for cached tokens")
+        .default_value<String>(".cstc-cache")
+    ;
     argparser.add_argument("--target")
         .help("target for cross-compiler")
         .default_value<String>("linux:x86:64:llvm")
@@ -64,6 +89,10 @@ int32 main(int32 argc, const char** argv){
         .help("entrypoint funtcion")
         .default_value<String>("main")
     ;
+    argparser.add_argument("--check-all")
+        .help("check all functions of imported modules, not only the used ones")
+        .flag()
+    ;
     argparser.add_argument("--no-std-lang")
         .help("disable autoloading std::lang module")
         .flag()
@@ -158,6 +187,10 @@ int32 main(int32 argc, const char** argv){
     parser::one_error = argparser["-1"] == true;
     lexer::pretty_size = argparser.get<int32>("--max-line-len");
     if (lexer::pretty_size < -1) lexer::pretty_size = -1;
+    lexer::threads = std::max(argparser.get<int32>("--lex-threads"), 0);
+    Module::check_all       = argparser["--check-all"] == true;
+    lexer::cache::enabled   = argparser["--no-cache"] == false;
+    lexer::cache::directory = argparser.get("--cache-dir");
 
     // try to load the main file
     String main_file = argparser.get("file");
@@ -190,12 +223,17 @@ int32 main(int32 argc, const char** argv){
 
     std::cout << "Parsing modules (" << 0 << "/" << Module::modules.size() << ")";
 
-    for (Module* m : Module::modules){
-        m->parse();
-    }
+    parser::stats.repeats = argparser["--stats"] == true;
+    Module::parseAll(std::max(argparser.get<int32>("--jobs"), 0));
 
     std::cout << "\r\e[32mParsing modules (" << Module::modules.size() << "/" << Module::modules.size() << ")\e[0m" << std::endl;
 
+    if (argparser["--stats"] == true){
+        std::cout << "\e[36;1mINFO: " << parser::stats.statements << " statements parsed, " << parser::stats.attempts << " statement parsers called ("
+                  << (parser::stats.statements == 0 ? 0.0 : (double) parser::stats.attempts / parser::stats.statements) << " per statement)\e[0m" << std::endl;
+        std::cout << "\e[36;1mINFO: " << parser::stats.expressions << " expressions parsed, " << parser::stats.repeated << " of them more than once\e[0m" << std::endl;
+    }
+
     if (parser::errc > 0 || parser::warnc > 0){
         std::cout << "\n";
         std::cout << parser::errc << " error" << (parser::errc == 1 ? ", " : "s, ") << parser::warnc << " warning" << (parser::warnc == 1 ? "" : "s") << " generated\n";
@@ -6,6 +6,7 @@
 //
 
 
+#include "lexer/cache.hpp"
 #include "lexer/errors.hpp"
 #include "lexer/lexer.hpp"
 #include "lexer/token.hpp"
@@ -17,18 +18,23 @@
 #include "parser/symboltable.hpp"
 #include "snippets.h"
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <asm-generic/errno.h>
 #include <cstdlib>
 #include <filesystem>
-#include <fstream>
 #include <list>
 #include <map>
 #include "module.hpp"
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
+#include <sstream>
 #include <sys/types.h>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -37,6 +43,7 @@ std::map<String, Module*> Module::known_modules = {};  //> A map of all compile-
 std::list<String> Module::unknown_modules = {};        //> A map of all compile-time unknown modules to allow better error messages
 std::list<Module*> Module::modules = {};               //> A list of all modules loaded. This is used to determine the compile order 
 std::fs::path Module::directory;                       //> Project directory
+bool Module::check_all = false;                        //> parse all function bodies, also unused ones of imported modules
 
 uint64 parsed_modules = 0; //> amount of parsed modules
 
@@ -142,6 +149,7 @@ Module* Module::create(String path, String, String overpath, bool is_stdlib,
 }
 
 Module::Module(String path, String dir, String module_name, bool is_stdlib, bool is_main_file){
+    kind = MODULE;
     loc = "";
     for (uint64 i = 0; i<module_name.size(); i++){
         if (i < module_name.size()-2 && module_name[i] == ':' && module_name[i+1] == ':'){
@@ -241,11 +249,11 @@ std::optional<std::vector<String>> getImportList(lexer::TokenStream t) {
 
     lexer::Token::Type last = lexer::Token::Type::COMMA;
 
-    for (lexer::Token tok : t.tokens) {
+    for (lexer::Token tok : t) {
         if (tok.type == lexer::Token::Type::COMMA) {};
         if (tok.type == lexer::Token::Type::ID) {
             if (last == lexer::Token::Type::COMMA) {
-                out.push_back(tok.value);
+                out.push_back(String(tok.value));
             } else {
                 return {};
             }
@@ -260,11 +268,9 @@ std::optional<std::vector<String>> getImportList(lexer::TokenStream t) {
  * @brief tokenize this module and parse for imports to include them
  */
 void Module::preprocess(){
-    std::ifstream f(cst_file.string());
-        String content((std::istreambuf_iterator<char>(f) ),
-                       (std::istreambuf_iterator<char>()));
-
-        tokens = lexer::tokenize(content, cst_file).tokens;
+        lexer::Source& source = lexer::sources.load(cst_file.string());
+        file   = source.id;
+        tokens = lexer::cache::tokenize(source);
         //std::cout << "\r" << module_name << ": " <<std::endl;
         //std::cout << tokens.size() << std::endl;
         //for (lexer::Token t : tokens){
@@ -303,7 +309,7 @@ void Module::preprocess(){
                         else if ((last == lexer::Token::DOTDOT || last == lexer::Token::ID) && a.type == lexer::Token::Type::AS){
                             
                             if (buffer.size() > i2+2 && buffer.at(i2+1).type == lexer::Token::Type::ID && buffer.at(i2+2).type == lexer::Token::Type::END_CMD){
-                                String as = buffer.at(i2+1).value;
+                                String as = String(buffer.at(i2+1).value);
                                 break;
                             } else {
                                 goto disallowed;
@@ -376,23 +382,210 @@ void Module::preprocess(){
             }
         }
         //std::cout << "end " << module_name << std::endl;
-    f.close();
+}
+
+static std::atomic<int64> spare_threads = 0; //> threads that may still be started to parse function bodies
+
+/**
+ * @brief take up to wanted of the spare threads
+ *
+ * @return amount of threads taken
+ */
+static uint64 borrowThreads(uint64 wanted){
+    int64 spare = spare_threads;
+    while (spare > 0 && !spare_threads.compare_exchange_weak(spare, spare - (int64) std::min<uint64>(spare, wanted))){}
+    return spare > 0 ? std::min<uint64>(spare, wanted) : 0;
+}
+
+/**
+ * @brief get the amount of diagnostics held back between two points
+ */
+static parser::Held heldBetween(parser::Held from, parser::Held to){
+    return {to.size - from.size, to.errc - from.errc, to.warnc - from.warnc};
 }
 
 /**
- * @brief parse this module and create AST nodes
+ * @brief parse this module and create AST nodes. All declarations are parsed first, so functions can be used
+ * before they are defined, then the function bodies. Their diagnostics are shown in source order anyway.
+ * Bodies of imported modules are only parsed once they are used, and their diagnostics are shown there.
  */
-void Module::parse(){
+void Module::parse(std::ostream& out){
+    // with -1 the first error has to stop at once, so nothing is held back and bodies are parsed in order
+    bool                              hold   = !parser::one_error;
+    std::vector<FuncDefAST::Deferred> bodies = {};
+    parser::Held                      start  = parser::held();
+
+    parser::Arena* outer = parser::arena;
+    parser::arena        = &arenas.emplace_back();
+
+    if (hold) parser::holding++;
+    FuncDefAST::deferred = &bodies;
     sptr<AST> root = SubBlockAST::parse(tokens, 0, this);
+    FuncDefAST::deferred = nullptr;
+    if (hold) parser::holding--;
+
+    String       declarations = "";
+    parser::Held declared     = hold ? parser::releaseHeld(start, declarations) : parser::Held{};
+
+    // bodies of imported modules wait until their function is used
+    if (!is_main_file && !check_all){
+        for (FuncDefAST::Deferred& d : bodies) FuncDefAST::parseLater(d.def);
+        bodies.clear();
+    }
+
+    // parse the bodies, on spare threads if there are any
+    std::vector<String>       texts(bodies.size());
+    std::vector<parser::Held> amounts(bodies.size());
+    std::atomic<uint64>       next = 0;
+    auto work = [&](){
+        for (uint64 k = next++; k < bodies.size(); k = next++){
+            parser::Held before = parser::held();
+            if (hold) parser::holding++;
+            bodies[k].def->parseBody();
+            if (hold) parser::holding--;
+            if (hold) amounts[k] = parser::releaseHeld(before, texts[k]);
+        }
+    };
+    std::vector<std::thread> helpers = {};
+    uint64 borrowed = hold && bodies.size() > 1 ? borrowThreads(bodies.size() - 1) : 0;
+    for (uint64 k = 0; k < borrowed; k++){
+        helpers.emplace_back([&work](parser::Arena* own){
+            parser::arena = own;
+            work();
+        }, &arenas.emplace_back());
+    }
+    work();
+    for (std::thread& h : helpers) h.join();
+    spare_threads += borrowed;
+
+    // put each body's diagnostics where it would have been parsed
+    if (hold){
+        parser::Held shown = {};
+        for (uint64 k = 0; k < bodies.size(); k++){
+            parser::Held at = heldBetween(start, bodies[k].at);
+            parser::replay(std::string_view(declarations).substr(shown.size, at.size - shown.size), heldBetween(shown, at));
+            parser::replay(texts[k], amounts[k]);
+            shown = at;
+        }
+        parser::replay(std::string_view(declarations).substr(shown.size), heldBetween(shown, declared));
+    }
+
     if (root != nullptr){
         int* i = new int;
         *i     = 0;
         //std::cout << str(root.get()) << std::endl;
-        std::cout << root->emitCST() << std::endl;
+        out << root->emitCST() << std::endl;
 
         delete i;
     }
-    std::cout << "\rParsing modules (" << ++parsed_modules << "/" << Module::modules.size() << ")";
+    parser::arena = outer;
 }
 
+/**
+ * @brief parse all modules. Independent modules are parsed on up to jobs threads, @see Module::parseAll
+ */
+void Module::parseAll(uint32 jobs){
+    std::vector<Module*> order(Module::modules.begin(), Module::modules.end());
+    uint64 n = order.size();
+    if (jobs == 0) jobs = std::max(std::thread::hardware_concurrency(), 1u);
+    if (parser::one_error) jobs = 1; // the first error has to stop before any later module is parsed
+
+    if (jobs == 1 || n <= 1){
+        spare_threads = jobs - 1;
+        for (Module* m : order){
+            m->parse(std::cout);
+            std::cout << "\rParsing modules (" << ++parsed_modules << "/" << n << ")";
+        }
+        return;
+    }
+
+    // find the modules each module depends on, directly or through others
+    std::map<Module*, uint64> index = {};
+    for (uint64 k = 0; k < n; k++) index[order[k]] = k;
+    std::vector<std::vector<bool>> reaches(n, std::vector<bool>(n, false)); //> reaches[a][b]: a depends on b
+    for (uint64 k = 0; k < n; k++){
+        std::vector<uint64> todo = {k};
+        auto visit = [&](symbol::Namespace* ns){
+            Module* d = dyn_cast<Module>(ns);
+            if (d == nullptr || index.count(d) == 0 || reaches[k][index[d]]) return;
+            reaches[k][index[d]] = true;
+            todo.push_back(index[d]);
+        };
+        while (!todo.empty()){
+            Module* m = order[todo.back()];
+            todo.pop_back();
+            for (std::pair<String, Module*> p : m->deps) visit(p.second);
+            for (symbol::Namespace* ns : m->include) visit(ns);
+        }
+    }
+
+    struct Job {
+        std::ostringstream  out         = {}; //> the module's CST
+        String              diagnostics = ""; //> held back messages
+        uint64              waiting     = 0;  //> modules that have to be parsed before this one
+        std::vector<uint64> then        = {}; //> modules waiting for this one
+        bool                done        = false;
+    };
+    // modules depending on each other (in any direction) are parsed in load order
+    std::vector<Job> job(n);
+    for (uint64 k = 0; k < n; k++){
+        for (uint64 j = 0; j < k; j++){
+            if (!reaches[k][j] && !reaches[j][k]) continue;
+            job[k].waiting++;
+            job[j].then.push_back(k);
+        }
+    }
 
+    std::mutex              lock;
+    std::condition_variable changed;
+    std::deque<uint64>      ready   = {};
+    uint64                  started = 0;
+    for (uint64 k = 0; k < n; k++){
+        if (job[k].waiting == 0) ready.push_back(k);
+    }
+
+    auto work = [&](){
+        std::unique_lock<std::mutex> guard(lock);
+        while (true){
+            changed.wait(guard, [&]{ return !ready.empty() || started == n; });
+            if (ready.empty()){
+                spare_threads++;
+                return;
+            }
+            uint64 k = ready.front();
+            ready.pop_front();
+            started++;
+            guard.unlock();
+
+            parser::holding++;
+            order[k]->parse(job[k].out);
+            parser::holding--;
+            String diagnostics = parser::takeHeld();
+
+            guard.lock();
+            job[k].diagnostics = std::move(diagnostics);
+            job[k].done        = true;
+            for (uint64 t : job[k].then){
+                if (--job[t].waiting == 0) ready.push_back(t);
+            }
+            changed.notify_all();
+        }
+    };
+    // workers that run out of modules are left to parse function bodies
+    std::vector<std::thread> workers = {};
+    spare_threads = jobs - std::min<uint64>(jobs, n);
+    for (uint32 w = 0; w < std::min<uint64>(jobs, n); w++) workers.emplace_back(work);
+
+    // show each module's output as soon as all modules before it are done
+    for (uint64 k = 0; k < n; k++){
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&]{ return job[k].done; });
+        }
+        std::cerr << job[k].diagnostics << std::flush;
+        String out = job[k].out.str();
+        if (!out.empty()) std::cout << out << std::flush;
+        std::cout << "\rParsing modules (" << ++parsed_modules << "/" << n << ")";
+    }
+    for (std::thread& w : workers) w.join();
+}
@@ -6,7 +6,9 @@
 // layouts the module class
 //
 
+#include "lexer/source.hpp"
 #include "lexer/token.hpp"
+#include "parser/arena.hpp"
 #include "parser/symboltable.hpp"
 #include "snippets.h"
 #include <list>
@@ -14,6 +16,7 @@
 #include <map>
 #include <filesystem>
 #include <optional>
+#include <ostream>
 
 namespace std {
     namespace fs = std::filesystem;
@@ -27,7 +30,9 @@ class Module final : public symbol::Namespace {
     bool is_main_file = false;                 //> whether this is the main module
     bool is_stdlib = false;                    //> whether this is a stdlib module
     std::map<String, Module *> deps = {};      //> dependency modules
-    std::vector<lexer::Token> tokens = {};     //> this module's tokens
+    lexer::FileId file = lexer::NO_FILE;       //> this module's source file
+    lexer::TokenStream tokens = lexer::TokenStream({}); //> this module's tokens
+    std::list<parser::Arena> arenas = {};               //> storage of this module's AST nodes, one for each thread parsing it
 
     protected:
     /**
@@ -38,8 +43,11 @@ class Module final : public symbol::Namespace {
 
     public:
 
+    CLASS_KIND(MODULE)
+
     String module_name;             //> representation module name
     static std::fs::path directory; //> main program directory
+    static bool check_all;          //> parse all function bodies instead of only the used ones of imported modules
     std::fs::path hst_file;         //> header location (relative)
     std::fs::path cst_file;         //> source location (relative)
 
@@ -56,9 +64,22 @@ class Module final : public symbol::Namespace {
     void preprocess();
 
     /**
-     * @brief parse this module and create AST nodes
+     * @brief parse this module and create AST nodes. Declarations are parsed before function bodies, which
+     * are parsed on spare threads (@see parseAll). Bodies in imported modules are only parsed once their
+     * function is used, unless check_all is set
+     *
+     * @param out stream the module's CST is written to
+     */
+    void parse(std::ostream& out);
+
+    /**
+     * @brief parse all modules. Modules that neither depend on each other directly nor indirectly are parsed
+     * on up to jobs threads, all others in load order. Output and diagnostics are shown in load order,
+     * so they are the same no matter how many threads are used.
+     *
+     * @param jobs maximum number of threads parsing modules or function bodies. 0 => one per hardware thread
      */
-    void parse();
+    static void parseAll(uint32 jobs);
 
     Module(String path, String dir, String name, bool is_stdlib=false, bool is_main_file=false);
 
@@ -0,0 +1,34 @@
+//
+// ARENA.cpp
+//
+// implements the storage for AST nodes
+//
+
+#include "arena.hpp"
+
+#include "../snippets.h"
+
+#include <cstdint>
+#include <memory>
+
+thread_local parser::Arena* parser::arena = nullptr;
+
+void* parser::Arena::allocate(uint64 size, uint64 align) {
+    if (size + align > BLOCK_SIZE) {
+        // too big to share a block, the current one is kept
+        blocks.push_back(std::unique_ptr<char[]>(new char[size + align]));
+        char* p = blocks.back().get();
+        return p + (align - (uintptr_t) p % align) % align;
+    }
+    uint64 pad = (align - (uintptr_t) next % align) % align;
+    if (next == nullptr || pad + size > left) {
+        blocks.push_back(std::unique_ptr<char[]>(new char[BLOCK_SIZE]));
+        next = blocks.back().get();
+        left = BLOCK_SIZE;
+        pad  = (align - (uintptr_t) next % align) % align;
+    }
+    void* p  = next + pad;
+    next    += pad + size;
+    left    -= pad + size;
+    return p;
+}
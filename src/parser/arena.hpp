@@ -0,0 +1,90 @@
+#pragma once
+
+//
+// ARENA.hpp
+//
+// layouts the storage for AST nodes
+//
+
+#include "../snippets.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace parser {
+    /**
+     * @class Arena hands out memory for AST nodes from large blocks. Nothing is freed on its own, all blocks are
+     * freed together with the arena, so it has to outlive all nodes in it. An arena may only be used by one
+     * thread at a time.
+     */
+    class Arena final {
+            std::vector<std::unique_ptr<char[]>> blocks = {};      //> all blocks, the last one is being filled
+            char*                                next   = nullptr; //> start of the free part of the last block
+            uint64                               left   = 0;       //> size of the free part of the last block
+
+        public:
+            static constexpr uint64 BLOCK_SIZE = 64 * 1024; //> size of a block. Bigger requests get their own one
+
+            Arena()                        = default;
+            Arena(const Arena&)            = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            /**
+             * @brief get memory for size bytes, aligned to align
+             */
+            void* allocate(uint64 size, uint64 align);
+    };
+
+    extern thread_local Arena* arena; //> arena new nodes of this thread are put in. nullptr to put them on the heap
+
+    /**
+     * @class ArenaAllocator is an allocator putting objects into an Arena, or on the heap if there is none.
+     * Deallocating memory of an arena does nothing.
+     */
+    template <typename T>
+    class ArenaAllocator final {
+            template <typename U>
+            friend class ArenaAllocator;
+
+            Arena* in = nullptr;
+
+        public:
+            using value_type = T;
+
+            ArenaAllocator(Arena* in) { this->in = in; }
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) {
+                this->in = other.in;
+            }
+
+            T* allocate(std::size_t n) {
+                if (in == nullptr) { return std::allocator<T>().allocate(n); }
+                return (T*) in->allocate(n * sizeof(T), alignof(T));
+            }
+
+            void deallocate(T* p, std::size_t n) {
+                if (in == nullptr) { std::allocator<T>().deallocate(p, n); }
+            }
+
+            template <typename U>
+            bool operator==(const ArenaAllocator<U>& other) const {
+                return in == other.in;
+            }
+
+            template <typename U>
+            bool operator!=(const ArenaAllocator<U>& other) const {
+                return in != other.in;
+            }
+    };
+
+    /**
+     * @brief create a node in this thread's arena. The node and its reference count are a single allocation
+     */
+    template <typename T, typename... Args>
+    sptr<T> make(Args&&... args) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    }
+} // namespace parser
@@ -19,6 +19,10 @@ CstType AST::getCstType() const {
     return "@unknown";
 }
 
+types::TypeId AST::getTypeId() const {
+    return types::intern(getCstType());
+}
+
 void AST::forceType(CstType){}
 
 String AST::emitLL(int*, String s) const {return s;}
@@ -8,6 +8,8 @@
 
 #include "../../lexer/token.hpp"
 #include "../../snippets.h"
+#include "../arena.hpp"
+#include "../types.hpp"
 
 #include <vector>
 
@@ -16,7 +18,7 @@
         String expected_type = "@unknown" //> used to template all parser functions
 #define PARSER_FN_PARAM      lexer::TokenStream tokens, int local, symbol::Namespace *sr, String expected_type
 #define PARSER_FN_NO_DEFAULT fsignal<sptr<AST>, lexer::TokenStream, int, symbol::Namespace*, String>
-#define ERR                  share<AST>(new AST)
+#define ERR                  parser::make<AST>()
 #define PUT_PT(s, a) (a? "("s + s + ")" : s)
 
 /**
@@ -28,22 +30,46 @@ class AST : public Repr {
          * @brief debug represenstation
          */
         virtual String     _str() const;
-        lexer::TokenStream tokens =
-            lexer::TokenStream({}); //> Tokens of this AST Node. these are mostly used for error messages
+        lexer::SourceRange tokens = {}; //> Tokens of this AST Node. these are mostly used for error messages
 
     public:
+        /**
+         * @enum Kind of all node classes. Subclasses of a class follow it, so a class and its subclasses are a range of
+         * kinds (@see isa)
+         */
+        enum Kind : uint8 {
+            // clang-format off
+            NODE,                  // plain AST, used for errorneous nodes
+            NAMESPACE, FUNC_DEF, SUB_BLOCK, IF, RETURN, VAR_DECL, VAR_INIT, VAR_ACCESS, DELETE,
+            ARRAY_FIELD_MULTIPLIER,
+
+            TYPE, OPTIONAL_TYPE, ARRAY_TYPE,
+
+            INT_LITERAL, BOOL_LITERAL, FLOAT_LITERAL, CHAR_LITERAL, STRING_LITERAL, NULL_LITERAL, EMPTY_LITERAL,
+            ARRAY_LITERAL,
+
+            ADD, SUB, MUL, DIV, MOD, POW, LOR, LAND, OR, AND, XOR, EQ, NEQ, GEQ, LEQ, GT, LT, // double operand
+            NOT, NEG,                                                                     // unary operand
+            FUNC_CALL, ARRAY_LENGTH, CAST, CHECK, NOWRAP, ADDR_OF, ARRAY_INDEX, VAR_SET,
+            // clang-format on
+        };
+
+        static constexpr Kind KIND = NODE;
+        CLASS_KINDS(NODE, VAR_SET)
+
         /**
          * @note since this class is thought as a replacement for errorneous ASTs, there is only a default constructor
          */
         AST() = default;
+        Kind   kind = NODE;      //> class of this node, set by its constructor (@see CLASS_KIND)
         String value;            //> value, used for several purposes
         bool   is_const = false; //> whether this is const and should be tried to be substituted in.
         bool   has_pt   = false; //> whether this AST has braces around it
 
         virtual ~AST() = default;
 
-        lexer::TokenStream getTokens() const { return tokens; }
-        void setTokens(lexer::TokenStream tokens) { this->tokens = tokens;}
+        lexer::SourceRange getTokens() const { return tokens; }
+        void setTokens(lexer::SourceRange tokens) { this->tokens = tokens;}
 
         /**
          * @brief get the LLVM IR type representation of this Nodes return type
@@ -55,6 +81,12 @@ class AST : public Repr {
          */
         virtual CstType getCstType() const;
 
+        /**
+         * @brief get the return type of this Node as an interned type. Nodes whose type takes work to find
+         * cache it, so asking again takes constant time
+         */
+        virtual types::TypeId getTypeId() const;
+
         /**
          * @brief make sure the expected type does match with the provided. may cast errors
          *
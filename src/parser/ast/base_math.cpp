@@ -3,8 +3,10 @@
 #include "../../build/optimizer_flags.hpp"
 #include "../../debug/debug.hpp"
 #include "../errors.hpp"
+#include "../fold.hpp"
 #include "../parser.hpp"
 #include "../symboltable.hpp"
+#include "../types.hpp"
 #include "ast.hpp"
 #include "func.hpp"
 #include "literal.hpp"
@@ -12,6 +14,7 @@
 #include "var.hpp"
 
 // #include <catch2/catch.hpp>
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <regex>
@@ -19,12 +22,25 @@
 #include <tuple>
 #include <vector>
 
+/**
+ * @brief whether an operand was folded and wrapped around on the way (@see ExpressionAST::wraps)
+ */
+static bool wrapsIn(const sptr<AST>& operand) {
+    ExpressionAST* e = dyn_cast<ExpressionAST>(operand.get());
+    return e != nullptr && e->wraps();
+}
+
 CstType DoubleOperandAST::getCstType() const {
-    return parser::hasOp(left->getCstType(), right->getCstType(), op);
+    return types::get(getTypeId()).name;
+}
+
+types::TypeId DoubleOperandAST::getTypeId() const {
+    if (resolved == types::NO_TYPE) { resolved = types::result(left->getTypeId(), right->getTypeId(), op); }
+    return resolved;
 }
 
 LLType DoubleOperandAST::getLLType() const {
-    return parser::LLType(getCstType());
+    return types::get(getTypeId()).ll;
 }
 
 uint64 DoubleOperandAST::nodeSize() const {
@@ -40,25 +56,23 @@ String DoubleOperandAST::emitCST() const {
 }
 
 void DoubleOperandAST::forceType(CstType type) {
-    std::regex i("u?int(8|16|32|64|128)");
-    std::regex f("float(16|32|64|128)");
-    bool       int_required   = std::regex_match(type, i);
-    bool       float_required = std::regex_match(type, f);
+    types::TypeId      expected = types::intern(type);
+    const types::Type& required = types::get(expected);
+    const types::Type& found    = types::get(left->getTypeId());
 
     // force the types of the sub-trees
-    if (std::regex_match(left->getCstType(), i) && int_required) {
-        left->forceType(type);
-        right->forceType(type);
-    }
-    if (std::regex_match(left->getCstType(), f) && float_required) {
+    if ((found.isSizedInt() && required.isSizedInt()) || (found.isFloat() && required.isFloat()) ||
+        (found.cls == types::Type::BOOL && required.cls == types::Type::BOOL)) {
         left->forceType(type);
         right->forceType(type);
+        resolved = types::NO_TYPE; // literals below may have been narrowed
     }
 
     // check for operator overloading [WIP/TODO]
-    CstType ret = parser::hasOp(left->getCstType(), right->getCstType(), op);
-    if (ret != "") {
-        if (ret != type) {
+    types::TypeId ret_id = getTypeId();
+    CstType       ret    = types::get(ret_id).name;
+    if (ret_id != types::NONE) {
+        if (ret_id != expected) {
             parser::error("Mismatiching types",
                           tokens,
                           left->getCstType() + "::operator " + op_view + " (" + right->getCstType() + ") yields " +
@@ -67,11 +81,13 @@ void DoubleOperandAST::forceType(CstType type) {
         }
 
         else if (optimizer::do_constant_folding && right->is_const && left->is_const) {
-            // std::cout << op_view << "constant_folding" << std::endl;
-            if (const_folding_fn.count(std::make_tuple(left->getCstType(), right->getCstType()))) {
-                value    = const_folding_fn[std::make_tuple(left->getCstType(), right->getCstType())](left->value,
-                                                                                                   right->value);
-                is_const = true;
+            fold::Constant c = fold::binary(op,
+                                            fold::read(left->getTypeId(), left->value),
+                                            fold::read(right->getTypeId(), right->value));
+            if (c.valid()) {
+                value     = fold::write(c);
+                is_const  = true;
+                overflows = c.overflow || wrapsIn(left) || wrapsIn(right);
             }
         }
     } else {
@@ -84,11 +100,19 @@ void DoubleOperandAST::forceType(CstType type) {
 }
 
 CstType UnaryOperandAST::getCstType() const {
-    return parser::hasOp(left->getCstType(), left->getCstType(), op);
+    return types::get(getTypeId()).name;
+}
+
+types::TypeId UnaryOperandAST::getTypeId() const {
+    if (resolved == types::NO_TYPE) {
+        types::TypeId of = left->getTypeId();
+        resolved         = types::result(of, of, op);
+    }
+    return resolved;
 }
 
 LLType UnaryOperandAST::getLLType() const {
-    return parser::LLType(getCstType());
+    return types::get(getTypeId()).ll;
 }
 
 uint64 UnaryOperandAST::nodeSize() const {
@@ -96,26 +120,39 @@ uint64 UnaryOperandAST::nodeSize() const {
 }
 
 void UnaryOperandAST::forceType(CstType type) {
-    String ret = parser::hasOp(left->getCstType(), left->getCstType(), op);
+    const types::Type& required = types::get(types::intern(type));
+    const types::Type& found    = types::get(left->getTypeId());
+
+    // ! and ~ yield the type of their operand, so it can be forced the same way
+    if ((found.isSizedInt() && required.isSizedInt()) ||
+        (found.cls == types::Type::BOOL && required.cls == types::Type::BOOL)) {
+        left->forceType(type);
+        resolved = types::NO_TYPE;
+    }
+
+    CstType of  = left->getCstType();
+    String  ret = getCstType();
     if (ret != "") {
         if (ret != type) {
             parser::error("Mismatiching types",
                           tokens,
-                          left->getCstType() + "::operator " + op_view + " () yields " + ret + " (expected \e[1m" +
+                          of + "::operator " + op_view + " () yields " + ret + " (expected \e[1m" +
                               type + "\e[0m)",
                           18);
         }
 
         else if (optimizer::do_constant_folding && left->is_const) {
-            if (const_folding_fn.count(left->getCstType())) {
-                value    = const_folding_fn[left->getCstType()](left->value);
-                is_const = true;
+            fold::Constant c = fold::unary(op, fold::read(left->getTypeId(), left->value));
+            if (c.valid()) {
+                value     = fold::write(c);
+                is_const  = true;
+                overflows = c.overflow || wrapsIn(left);
             }
         }
     } else {
         parser::error("Unknown operator",
                       tokens,
-                      left->getCstType() + "::operator " + op_view + " () is not implemented.",
+                      of + "::operator " + op_view + " () is not implemented.",
                       18);
     }
 }
@@ -130,39 +167,13 @@ String UnaryOperandAST::_str() const {
 
 //  AddAST
 
-#define CF_FUN_INT(type1, type2, type, op)                                                         \
-    {std::make_tuple(type1, type2),                                                                \
-     nlambda(String v1, String v2) {return std::to_string(type(std::stoll(v1) op std::stoll(v2))); \
-    }                                                                                              \
-    }
-#define CF_FUN_FLT(type1, type2, type, op)                                                         \
-    {std::make_tuple(type1, type2),                                                                \
-     nlambda(String v1, String v2) {return std::to_string(type(std::stold(v1) op std::stold(v2))); \
-    }                                                                                              \
-    }
-
 AddAST::AddAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::ADD;
-    this->op_view          = "+";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, +),
-        CF_FUN_INT("uint16", "uint16", uint16, +),
-        CF_FUN_INT("uint32", "uint32", uint32, +),
-        CF_FUN_INT("uint64", "uint64", uint64, +),
-
-        CF_FUN_INT("int8", "int8", int8, +),
-        CF_FUN_INT("int16", "int16", int16, +),
-        CF_FUN_INT("int32", "int32", int32, +),
-        CF_FUN_INT("int64", "int64", int64, +),
-
-        CF_FUN_FLT("float16", "float16", float32, +),
-        CF_FUN_FLT("float32", "float32", float32, +),
-        CF_FUN_FLT("float64", "float64", float64, +),
-        CF_FUN_FLT("float80", "float80", float80, +),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::ADD;
+    this->op_view = "+";
 }
 
 AddAST::~AddAST() {};
@@ -192,7 +203,7 @@ sptr<AST> AddAST::parse(PARSER_FN_PARAM) {
                           m.before(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
 
         sptr<AST> right = math::parse(m.after(), local, sr, expected_type);
@@ -201,16 +212,16 @@ sptr<AST> AddAST::parse(PARSER_FN_PARAM) {
                           m.after(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
         lexer::Token op = tokens[m];
         DEBUG(3, "\top.type: "s + lexer::getTokenName(op.type))
         if (op.type == lexer::Token::Type::ADD) {
-            return share<AST>(new AddAST(left, right, tokens));
+            return parser::make<AddAST>(left, right, tokens);
         }
 
         else if (op.type == lexer::Token::Type::SUB) {
-            return share<AST>(new SubAST(left, right, tokens));
+            return parser::make<SubAST>(left, right, tokens);
         }
     }
     return nullptr;
@@ -219,27 +230,12 @@ sptr<AST> AddAST::parse(PARSER_FN_PARAM) {
 // SubAST
 
 SubAST::SubAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::SUB;
-    this->op_view          = "-";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, -),
-        CF_FUN_INT("uint16", "uint16", uint16, -),
-        CF_FUN_INT("uint32", "uint32", uint32, -),
-        CF_FUN_INT("uint64", "uint64", uint64, -),
-
-        CF_FUN_INT("int8", "int8", int8, -),
-        CF_FUN_INT("int16", "int16", int16, -),
-        CF_FUN_INT("int32", "int32", int32, -),
-        CF_FUN_INT("int64", "int64", int64, -),
-
-        CF_FUN_FLT("float16", "float16", float32, -),
-        CF_FUN_FLT("float32", "float32", float32, -),
-        CF_FUN_FLT("float64", "float64", float64, -),
-        CF_FUN_FLT("float80", "float80", float80, -),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::SUB;
+    this->op_view = "-";
 }
 
 SubAST::~SubAST() {};
@@ -258,27 +254,12 @@ String SubAST::emitLL(int* locc, String inp) const {
 // MulAST
 
 MulAST::MulAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::MUL;
-    this->op_view          = "*";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, *),
-        CF_FUN_INT("uint16", "uint16", uint16, *),
-        CF_FUN_INT("uint32", "uint32", uint32, *),
-        CF_FUN_INT("uint64", "uint64", uint64, *),
-
-        CF_FUN_INT("int8", "int8", int8, *),
-        CF_FUN_INT("int16", "int16", int16, *),
-        CF_FUN_INT("int32", "int32", int32, *),
-        CF_FUN_INT("int64", "int64", int64, *),
-
-        CF_FUN_FLT("float16", "float16", float32, *),
-        CF_FUN_FLT("float32", "float32", float32, *),
-        CF_FUN_FLT("float64", "float64", float64, *),
-        CF_FUN_FLT("float80", "float80", float80, *),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::MUL;
+    this->op_view = "*";
 }
 
 MulAST::~MulAST() {};
@@ -307,7 +288,7 @@ sptr<AST> MulAST::parse(PARSER_FN_PARAM) {
                           m.before(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
 
         sptr<AST> right = math::parse(m.after(), local, sr, expected_type);
@@ -316,20 +297,20 @@ sptr<AST> MulAST::parse(PARSER_FN_PARAM) {
                           m.after(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
         lexer::Token op = tokens[m];
         DEBUG(3, "\top.type: "s + lexer::getTokenName(op.type))
         if (op.type == lexer::Token::Type::MUL) {
-            return share<AST>(new MulAST(left, right, tokens));
+            return parser::make<MulAST>(left, right, tokens);
         }
 
         else if (op.type == lexer::Token::Type::DIV) {
-            return share<AST>(new DivAST(left, right, tokens));
+            return parser::make<DivAST>(left, right, tokens);
         }
 
         else if (op.type == lexer::Token::Type::MOD) {
-            return share<AST>(new DivAST(left, right, tokens));
+            return parser::make<ModAST>(left, right, tokens);
         }
     }
     return nullptr;
@@ -338,27 +319,12 @@ sptr<AST> MulAST::parse(PARSER_FN_PARAM) {
 // DivAST
 
 DivAST::DivAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::DIV;
-    this->op_view          = "/";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, /),
-        CF_FUN_INT("uint16", "uint16", uint16, /),
-        CF_FUN_INT("uint32", "uint32", uint32, /),
-        CF_FUN_INT("uint64", "uint64", uint64, /),
-
-        CF_FUN_INT("int8", "int8", int8, /),
-        CF_FUN_INT("int16", "int16", int16, /),
-        CF_FUN_INT("int32", "int32", int32, /),
-        CF_FUN_INT("int64", "int64", int64, /),
-
-        CF_FUN_FLT("float16", "float16", float32, /),
-        CF_FUN_FLT("float32", "float32", float32, /),
-        CF_FUN_FLT("float64", "float64", float64, /),
-        CF_FUN_FLT("float80", "float80", float80, /),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::DIV;
+    this->op_view = "/";
 }
 
 DivAST::~DivAST() {};
@@ -377,22 +343,12 @@ String DivAST::emitLL(int* locc, String inp) const {
 // ModAST
 
 ModAST::ModAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::MOD;
-    this->op_view          = "%";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, %),
-        CF_FUN_INT("uint16", "uint16", uint16, %),
-        CF_FUN_INT("uint32", "uint32", uint32, %),
-        CF_FUN_INT("uint64", "uint64", uint64, %),
-
-        CF_FUN_INT("int8", "int8", int8, %),
-        CF_FUN_INT("int16", "int16", int16, %),
-        CF_FUN_INT("int32", "int32", int32, %),
-        CF_FUN_INT("int64", "int64", int64, %),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::MOD;
+    this->op_view = "%";
 }
 
 ModAST::~ModAST() {};
@@ -410,41 +366,13 @@ String ModAST::emitLL(int* locc, String inp) const {
 
 // PowAST
 
-#define CF_FUN_POW(type, type2)                                                                                    \
-    {std::make_tuple(type, type),                                                                                  \
-     nlambda(String v1,                                                                                            \
-             String v2) {return std::to_string(type2(std::pow(float80(std::stoll(v1)), float80(std::stoll(v2))))); \
-    }                                                                                                              \
-    }
-#define CF_FUN_POW_FLT(type, type2)                                                                                \
-    {std::make_tuple(type, type),                                                                                  \
-     nlambda(String v1,                                                                                            \
-             String v2) {return std::to_string(type2(std::pow(float80(std::stold(v1)), float80(std::stold(v2))))); \
-    }                                                                                                              \
-    }
-
 PowAST::PowAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::POW;
-    this->op_view          = "**";
-    this->const_folding_fn = {
-        CF_FUN_POW("uint8", uint8),
-        CF_FUN_POW("uint16", uint16),
-        CF_FUN_POW("uint32", uint32),
-        CF_FUN_POW("uint64", uint64),
-
-        CF_FUN_POW("int8", int8),
-        CF_FUN_POW("int16", int16),
-        CF_FUN_POW("int32", int32),
-        CF_FUN_POW("int64", int64),
-
-        CF_FUN_POW_FLT("float16", float32),
-        CF_FUN_POW_FLT("float32", float32),
-        CF_FUN_POW_FLT("float64", float64),
-        CF_FUN_POW_FLT("float80", float80),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::POW;
+    this->op_view = "**";
 }
 
 PowAST::~PowAST() = default;
@@ -463,7 +391,7 @@ String PowAST::emitLL(int*, String) const {
                           m.before(),                                                     \
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m", \
                           111);                                                           \
-            return share<AST>(new AST());                                                 \
+            return parser::make<AST>();                                                   \
         }                                                                                 \
                                                                                           \
         sptr<AST> right = math::parse(m.after(), local, sr, expected_type);               \
@@ -472,10 +400,10 @@ String PowAST::emitLL(int*, String) const {
                           m.after(),                                                      \
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m", \
                           111);                                                           \
-            return share<AST>(new AST());                                                 \
+            return parser::make<AST>();                                                   \
         }                                                                                 \
         lexer::Token op = tokens[m];                                                      \
-        if (op.type == tokentype) return share<AST>(new type1(left, right, tokens));      \
+        if (op.type == tokentype) return parser::make<type1>(left, right, tokens);        \
     }
 
 sptr<AST> PowAST::parse(PARSER_FN_PARAM) {
@@ -487,18 +415,12 @@ sptr<AST> PowAST::parse(PARSER_FN_PARAM) {
 // LorAST
 
 LorAST::LorAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::LOR;
-    this->op_view          = "||";
-    this->const_folding_fn = {
-        {std::make_tuple("bool", "bool"),
-         nlambda(String v1, String v2) {return (v1 == "true"s || v2 == "true") ? "true"s : "false"s;
-}
-}
-}
-;
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::LOR;
+    this->op_view = "||";
 }
 
 LorAST::~LorAST() {};
@@ -523,18 +445,12 @@ sptr<AST> LorAST::parse(PARSER_FN_PARAM) {
 // LandAST
 
 LandAST::LandAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::LAND;
-    this->op_view          = "&&";
-    this->const_folding_fn = {
-        {std::make_tuple("bool", "bool"),
-         nlambda(String v1, String v2) {return (v1 == "true"s && v2 == "true") ? "true"s : "false"s;
-}
-}
-}
-;
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::LAND;
+    this->op_view = "&&";
 }
 
 LandAST::~LandAST() {};
@@ -559,22 +475,12 @@ sptr<AST> LandAST::parse(PARSER_FN_PARAM) {
 // OrAST
 
 OrAST::OrAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::OR;
-    this->op_view          = "|";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, |),
-        CF_FUN_INT("uint16", "uint16", uint16, |),
-        CF_FUN_INT("uint32", "uint32", uint32, |),
-        CF_FUN_INT("uint64", "uint64", uint64, |),
-
-        CF_FUN_INT("int8", "int8", int8, |),
-        CF_FUN_INT("int16", "int16", int16, |),
-        CF_FUN_INT("int32", "int32", int32, |),
-        CF_FUN_INT("int64", "int64", int64, |),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::OR;
+    this->op_view = "|";
 }
 
 String OrAST::emitLL(int* locc, String inp) const {
@@ -597,22 +503,12 @@ sptr<AST> OrAST::parse(PARSER_FN_PARAM) {
 // AndAST
 
 AndAST::AndAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::AND;
-    this->op_view          = "&";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, &),
-        CF_FUN_INT("uint16", "uint16", uint16, &),
-        CF_FUN_INT("uint32", "uint32", uint32, &),
-        CF_FUN_INT("uint64", "uint64", uint64, &),
-
-        CF_FUN_INT("int8", "int8", int8, &),
-        CF_FUN_INT("int16", "int16", int16, &),
-        CF_FUN_INT("int32", "int32", int32, &),
-        CF_FUN_INT("int64", "int64", int64, &),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::AND;
+    this->op_view = "&";
 }
 
 String AndAST::emitLL(int* locc, String inp) const {
@@ -628,29 +524,19 @@ String AndAST::emitLL(int* locc, String inp) const {
 
 sptr<AST> AndAST::parse(lexer::TokenStream tokens, int local, symbol::Namespace* sr, String expected_type) {
     DEBUG(2, "AndAST::parse");
-    STANDARD_MATH_PARSE(lexer::Token::AND, AddAST);
+    STANDARD_MATH_PARSE(lexer::Token::AND, AndAST);
     return nullptr;
 }
 
 // XorAST
 
 XorAST::XorAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::XOR;
-    this->op_view          = "^";
-    this->const_folding_fn = {
-        CF_FUN_INT("uint8", "uint8", uint8, ^),
-        CF_FUN_INT("uint16", "uint16", uint16, ^),
-        CF_FUN_INT("uint32", "uint32", uint32, ^),
-        CF_FUN_INT("uint64", "uint64", uint64, ^),
-
-        CF_FUN_INT("int8", "int8", int8, ^),
-        CF_FUN_INT("int16", "int16", int16, ^),
-        CF_FUN_INT("int32", "int32", int32, ^),
-        CF_FUN_INT("int64", "int64", int64, ^),
-    };
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::XOR;
+    this->op_view = "^";
 }
 
 String XorAST::emitLL(int* locc, String inp) const {
@@ -673,17 +559,12 @@ sptr<AST> XorAST::parse(PARSER_FN_PARAM) {
 // EqAST
 
 EqAST::EqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::EQ;
-    this->op_view          = "==";
-    this->const_folding_fn = {
-        {std::make_tuple("bool", "bool"), nlambda(String v1, String v2) {return (v1 == v2) ? "true"s : "false"s;
-}
-}
-}
-;
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::EQ;
+    this->op_view = "==";
 }
 
 String EqAST::emitLL(int* locc, String inp) const {
@@ -699,17 +580,12 @@ sptr<AST> EqAST::parse(PARSER_FN_PARAM) {
 // NeqAST
 
 NeqAST::NeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::NEQ;
-    this->op_view          = "!=";
-    this->const_folding_fn = {
-        {std::make_tuple("bool", "bool"), nlambda(String v1, String v2) {return (v1 != v2) ? "true"s : "false"s;
-}
-}
-}
-;
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::NEQ;
+    this->op_view = "!=";
 }
 
 String NeqAST::emitLL(int* locc, String inp) const {
@@ -718,7 +594,7 @@ String NeqAST::emitLL(int* locc, String inp) const {
 
 sptr<AST> NeqAST::parse(PARSER_FN_PARAM) {
     DEBUG(4, "Trying \e[1mNeqAST::parse\e[0m");
-    STANDARD_MATH_PARSE(lexer::Token::NEQ, EqAST);
+    STANDARD_MATH_PARSE(lexer::Token::NEQ, NeqAST);
     return nullptr;
 }
 
@@ -735,7 +611,7 @@ sptr<AST> GtAST::parse(PARSER_FN_PARAM) {
                           m.before(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
 
         sptr<AST> right = math::parse(m.after(), local, sr, expected_type);
@@ -744,10 +620,10 @@ sptr<AST> GtAST::parse(PARSER_FN_PARAM) {
                           m.after(),
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m",
                           111);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
         lexer::Token op = tokens[m];
-        if (op.type == tokentype) { return share<AST>(new GtAST(left, right, tokens)); }
+        if (op.type == tokentype) { return parser::make<GtAST>(left, right, tokens); }
     }
     return nullptr;
 }*/
@@ -755,12 +631,12 @@ sptr<AST> GtAST::parse(PARSER_FN_PARAM) {
 
 // GtAST
 GtAST::GtAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::GREATER;
-    this->op_view          = ">";
-    this->const_folding_fn = {};
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::GREATER;
+    this->op_view = ">";
 }
 
 String GtAST::emitLL(int* locc, String inp) const {
@@ -775,12 +651,12 @@ sptr<AST> GtAST::parse(PARSER_FN_PARAM) {
 
 // LtAST
 LtAST::LtAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::LESS;
-    this->op_view          = "<";
-    this->const_folding_fn = {};
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::LESS;
+    this->op_view = "<";
 }
 
 String LtAST::emitLL(int* locc, String inp) const {
@@ -795,12 +671,12 @@ sptr<AST> LtAST::parse(PARSER_FN_PARAM) {
 
 // GeqAST
 GeqAST::GeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::GEQ;
-    this->op_view          = ">=";
-    this->const_folding_fn = {};
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::GEQ;
+    this->op_view = ">=";
 }
 
 String GeqAST::emitLL(int* locc, String inp) const {
@@ -815,12 +691,12 @@ sptr<AST> GeqAST::parse(PARSER_FN_PARAM) {
 
 // LeqAST
 LeqAST::LeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
-    this->left             = left;
-    this->right            = right;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::LEQ;
-    this->op_view          = "<=";
-    this->const_folding_fn = {};
+    kind          = KIND;
+    this->left    = left;
+    this->right   = right;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::LEQ;
+    this->op_view = "<=";
 }
 
 String LeqAST::emitLL(int* locc, String inp) const {
@@ -837,15 +713,11 @@ sptr<AST> LeqAST::parse(PARSER_FN_PARAM) {
 // NotAST
 
 NotAST::NotAST(sptr<AST> inner, lexer::TokenStream tokens) {
-    this->left             = inner;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::NOT;
-    this->op_view          = "!";
-    this->const_folding_fn = {{"bool", nlambda(String v) {return (v == "true" ? "false"s : "true"s);
-}
-}
-}
-;
+    kind          = KIND;
+    this->left    = inner;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::NOT;
+    this->op_view = "!";
 }
 
 #define UNARY_MATH_PARSE(tokentype, type1, after)                                                        \
@@ -857,9 +729,9 @@ NotAST::NotAST(sptr<AST> inner, lexer::TokenStream tokens) {
                           tokens.slice(1, 1, 1),                                                         \
                           "Expected espression of type \e[1m"s + expected_type + "\e[0m after " + after, \
                           111);                                                                          \
-            return share<AST>(new AST);                                                                  \
+            return parser::make<AST>();                                                                  \
         }                                                                                                \
-        return share<AST>(new type1(of, tokens));                                                        \
+        return parser::make<type1>(of, tokens);                                                          \
     }
 
 sptr<AST> NotAST::parse(PARSER_FN_PARAM) {
@@ -872,39 +744,11 @@ sptr<AST> NotAST::parse(PARSER_FN_PARAM) {
 // NegAST
 
 NegAST::NegAST(sptr<AST> inner, lexer::TokenStream tokens) {
-    this->left             = inner;
-    this->tokens           = tokens;
-    this->op               = lexer::Token::NEG;
-    this->op_view          = "~";
-    this->const_folding_fn = {{"uint8"s, nlambda(String v) {return std::to_string(~(uint8) (std::stoi(v)));
-}
-}
-, {"uint16"s, nlambda(String v) {return std::to_string(~(uint16) (std::stoi(v)));
-}
-}
-, {"uint32"s, nlambda(String v) {return std::to_string(~(uint32) (std::stol(v)));
-}
-}
-, {"uint64"s, nlambda(String v) {return std::to_string(~(uint64) (std::stoll(v)));
-}
-}
-,
-
-    {"int8"s, nlambda(String v) {return std::to_string(~(int8) (std::stoi(v)));
-}
-}
-, {"int16"s, nlambda(String v) {return std::to_string(~(int16) (std::stoi(v)));
-}
-}
-, {"int32"s, nlambda(String v) {return std::to_string(~(int32) (std::stol(v)));
-}
-}
-, {"int64"s, nlambda(String v) {return std::to_string(~(int64) (std::stoll(v)));
-}
-}
-,
-}
-;
+    kind          = KIND;
+    this->left    = inner;
+    this->tokens  = tokens;
+    this->op      = lexer::Token::NEG;
+    this->op_view = "~";
 }
 
 sptr<AST> NegAST::parse(PARSER_FN_PARAM) {
@@ -917,6 +761,7 @@ sptr<AST> NegAST::parse(PARSER_FN_PARAM) {
 // AddrOfAST
 
 AddrOfAST::AddrOfAST(sptr<AST> of) {
+    kind     = KIND;
     this->of = of;
 }
 
@@ -950,6 +795,7 @@ sptr<AST> math::parse_pt(PARSER_FN_PARAM) {
 }
 
 CastAST::CastAST(sptr<AST> from, sptr<AST> type, lexer::TokenStream tokens) {
+    kind         = KIND;
     this->from   = from;
     this->type   = type;
     this->tokens = tokens;
@@ -963,23 +809,23 @@ sptr<AST> CastAST::parse(PARSER_FN_PARAM) {
         DEBUG(2, "CastAST::parse");
         if ((uint64) m == tokens.size() - 1) {
             parser::error("Expected type", tokens.getTS(m), "Expected a type after 'as'", 25);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
         if ((uint64) m == 0) {
             parser::error("Expression expected", tokens.getTS(0), "Expected a valid expression", 31);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
         sptr<AST> type = Type::parse(m.after(), local, sr);
         if (type == nullptr) {
             parser::error("Expected type", m.after(), "Expected a type after 'as'", 25);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
         sptr<AST> expr = math::parse(m.before(), local, sr);
         if (expr == nullptr) {
             parser::error("Expression expected", m.before(), "Expected a valid expression", 31);
-            return share<AST>(new AST());
+            return parser::make<AST>();
         }
-        return share<AST>(new CastAST(expr, type, tokens));
+        return parser::make<CastAST>(expr, type, tokens);
     }
     return nullptr;
 }
@@ -1103,7 +949,7 @@ sptr<AST> CheckAST::parse(PARSER_FN_PARAM) {
             }
             return nullptr;
         }
-        return share<AST>(new CheckAST(of, tokens));
+        return parser::make<CheckAST>(of, tokens);
     }
     return nullptr;
 }
@@ -1137,14 +983,14 @@ sptr<AST> NoWrapAST::parse(PARSER_FN_PARAM) {
         DEBUGT(2, "NoWrapAST::parse", &tokens);
         if (tokens[1].type != lexer::Token::OPEN) {
             parser::error("Expected Block open", {tokens[0]}, "Expected a '(' token after 'nowrap'", 0);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
         if (tokens[-1].type != lexer::Token::CLOSE) {
             parser::error("Expected Block close",
                           {tokens[-1]},
-                          "Expected a ')' token after '"s + tokens[-1].value + "'",
+                          "Expected a ')' token after '"s + String(tokens[-1].value) + "'",
                           0);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
         sptr<AST> a = math::parse(tokens.slice(2, 1, -1), local + 1, sr);
         if (a == nullptr) {
@@ -1152,18 +998,30 @@ sptr<AST> NoWrapAST::parse(PARSER_FN_PARAM) {
                           tokens.slice(2, 1, -1),
                           "Expected a valid expression in nowrap block",
                           0);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
-        if (! instanceOf(a, DoubleOperandAST)) { // currently, nowrap can only be used on operators. Unary operands (~ and !) never wrap and only double have to be checked
+        if (! instanceOf(a, DoubleOperandAST) && ! instanceOf(a, UnaryOperandAST)) { // currently, nowrap can only be used on operators. Unary operands (~ and !) never wrap themselves, but their operand may
             return a;
         }
-        return share<AST>(new NoWrapAST(a, tokens));
+        return parser::make<NoWrapAST>(a, tokens);
     }
     return nullptr;
 }
 
 void NoWrapAST::forceType(CstType type) {
     of->forceType(type);
+
+    // overflows stays unset, so enclosing nowraps do not report this again
+    if (wrapsIn(of)) {
+        parser::error("Integer overflow",
+                      tokens,
+                      "this constant expression wraps around, which is not allowed in a nowrap block",
+                      17);
+    }
+    if (of->is_const) {
+        value    = of->value;
+        is_const = true;
+    }
 }
 
 sptr<AST> ArrayIndexAST::parse(PARSER_FN_PARAM){
@@ -1189,7 +1047,7 @@ sptr<AST> ArrayIndexAST::parse(PARSER_FN_PARAM){
                 parser::error("Expected expression", tok, "expected a valid expression", 0);
                 return ERR;
             }
-            return share<AST>(new ArrayIndexAST(tokens, of, idx));
+            return parser::make<ArrayIndexAST>(tokens, of, idx);
         }
     }
     return nullptr;
@@ -1199,8 +1057,239 @@ void ArrayIndexAST::forceType(CstType type){
     of->forceType(type + "[]");
 }
 
+// operator precedence
+
+/**
+ * @brief get the precedence of a binary operator, 0 if the token is none. The operators are tried in this order by
+ * math::parse, so the first one splits an expression and binds loosest.
+ */
+static int precedence(lexer::Token::Type type) {
+    switch (type) {
+        case lexer::Token::LAND:    return 1;
+        case lexer::Token::LOR:     return 2;
+        case lexer::Token::EQ:      return 3;
+        case lexer::Token::NEQ:     return 4;
+        case lexer::Token::GEQ:     return 5;
+        case lexer::Token::LEQ:     return 6;
+        case lexer::Token::GREATER: return 7;
+        case lexer::Token::LESS:    return 8;
+        case lexer::Token::ADD:
+        case lexer::Token::SUB:     return 9;
+        case lexer::Token::MUL:
+        case lexer::Token::DIV:
+        case lexer::Token::MOD:     return 10;
+        case lexer::Token::POW:     return 11;
+        case lexer::Token::AND:     return 12;
+        case lexer::Token::OR:      return 13;
+        case lexer::Token::XOR:     return 14;
+        default:                    return 0;
+    }
+}
+
+constexpr int NOT_PRECEDENCE = 12; //> '!' is tried after '**', but before '&', so it takes those with it
+
+/**
+ * @class OperatorTree lays out the operators of an expression by precedence climbing, in one pass over it.
+ * It gives the same tree splitting at the loosest operator again and again (as the operator parse functions do)
+ * would, but does not create any ASTs. Expressions another parser would take first (e.g. a variable set or an
+ * expression ending on an index) are left to them.
+ */
+class OperatorTree final {
+    public:
+        struct Node {
+                lexer::Token::Type op;          //> the operator, NONE for operands
+                uint64             begin, end;  //> the tokens the node spans
+                int64              left  = -1;  //> the left operand or the operand of unary operators
+                int64              right = -1;  //> the right operand
+        };
+
+        std::vector<Node> nodes = {}; //> all nodes, the root is the last one
+
+        /**
+         * @brief lay out an expression
+         *
+         * @return false if it has no operators or has to be parsed another way
+         */
+        bool build(const lexer::TokenStream& tokens) {
+            this->tokens = &tokens;
+            pos          = 0;
+            int64 root   = expression(0);
+            return root >= 0 && nodes[root].op != lexer::Token::NONE;
+        }
+
+    private:
+        const lexer::TokenStream* tokens = nullptr;
+        uint64                    pos    = 0; //> the next token to look at
+
+        /**
+         * @brief parse operators of at least min_precedence
+         */
+        int64 expression(int min_precedence) {
+            int64 left = operand(min_precedence);
+            while (left >= 0 && pos < tokens->size()) {
+                lexer::Token::Type op = tokens->type(pos);
+                int                p  = precedence(op);
+                if (p < min_precedence) { break; }
+                pos++;
+                int64 right = expression(p + 1); // binary operators are left associative
+                if (right < 0) { return -1; }
+                left = add({op, nodes[left].begin, nodes[right].end, left, right});
+            }
+            return left;
+        }
+
+        /**
+         * @brief parse a unary operator or the tokens up to the next binary operator
+         */
+        int64 operand(int min_precedence) {
+            if (pos >= tokens->size()) { return -1; }
+            uint64             begin = pos;
+            lexer::Token::Type type  = tokens->type(pos);
+            if (type == lexer::Token::NEG || type == lexer::Token::NOT) {
+                // '~' is tried before any binary operator and takes the rest of the operand with it
+                pos++;
+                int64 of = expression(type == lexer::Token::NOT ? std::max(min_precedence, NOT_PRECEDENCE) : min_precedence);
+                if (of < 0) { return -1; }
+                return add({type, begin, nodes[of].end, of});
+            }
+
+            for (; pos < tokens->size() && precedence(tokens->type(pos)) == 0; pos++) {
+                switch (tokens->type(pos)) {
+                    case lexer::Token::OPEN:
+                    case lexer::Token::BLOCK_OPEN:
+                    case lexer::Token::INDEX_OPEN: {
+                        int64 p = tokens->partner(pos);
+                        if (p < 0) { return -1; }
+                        pos = p;
+                        break;
+                    }
+                    case lexer::Token::CLOSE:
+                    case lexer::Token::BLOCK_CLOSE:
+                    case lexer::Token::INDEX_CLOSE:
+                    case lexer::Token::SET:         return -1;
+                    default:                        break;
+                }
+            }
+            if (pos == begin) { return -1; }
+            nodes.push_back({lexer::Token::NONE, begin, pos});
+            return nodes.size() - 1;
+        }
+
+        /**
+         * @brief add an operator node. If another parser is tried before the operator's and might match its tokens,
+         * they are added as an operand instead, so math::parse decides
+         */
+        int64 add(Node node) {
+            lexer::Token::Type first = tokens->type(node.begin);
+            lexer::Token::Type last  = tokens->type(node.end - 1);
+            if ((first == lexer::Token::OPEN && last == lexer::Token::CLOSE) || // parse_pt
+                last == lexer::Token::INDEX_CLOSE ||                            // ArrayIndexAST, ArrayLiteralAST
+                first == lexer::Token::SUB || first == lexer::Token::NEC ||     // negative literals
+                first == lexer::Token::SUBNS) {                                 // names
+                node = {lexer::Token::NONE, node.begin, node.end};
+            }
+            nodes.push_back(node);
+            return nodes.size() - 1;
+        }
+};
+
+/**
+ * @brief create a binary operator's AST. The classes are the ones the operators' parse functions create
+ */
+static sptr<AST> binaryOperator(lexer::Token::Type op, sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens) {
+    switch (op) {
+        case lexer::Token::LAND:    return parser::make<LandAST>(left, right, tokens);
+        case lexer::Token::LOR:     return parser::make<LorAST>(left, right, tokens);
+        case lexer::Token::EQ:      return parser::make<EqAST>(left, right, tokens);
+        case lexer::Token::NEQ:     return parser::make<NeqAST>(left, right, tokens);
+        case lexer::Token::GEQ:     return parser::make<GeqAST>(left, right, tokens);
+        case lexer::Token::LEQ:     return parser::make<LeqAST>(left, right, tokens);
+        case lexer::Token::GREATER: return parser::make<GtAST>(left, right, tokens);
+        case lexer::Token::LESS:    return parser::make<LtAST>(left, right, tokens);
+        case lexer::Token::ADD:     return parser::make<AddAST>(left, right, tokens);
+        case lexer::Token::AND:     return parser::make<AndAST>(left, right, tokens);
+        case lexer::Token::SUB:     return parser::make<SubAST>(left, right, tokens);
+        case lexer::Token::MUL:     return parser::make<MulAST>(left, right, tokens);
+        case lexer::Token::DIV:     return parser::make<DivAST>(left, right, tokens);
+        case lexer::Token::MOD:     return parser::make<ModAST>(left, right, tokens);
+        case lexer::Token::POW:     return parser::make<PowAST>(left, right, tokens);
+        case lexer::Token::OR:      return parser::make<OrAST>(left, right, tokens);
+        case lexer::Token::XOR:     return parser::make<XorAST>(left, right, tokens);
+        default:                    return nullptr;
+    }
+}
+
+/**
+ * @brief create the ASTs of a node of an OperatorTree. Operands are parsed left to right and errors are the ones
+ * of the operators' parse functions.
+ */
+static sptr<AST> buildOperators(const OperatorTree& tree, int64 idx, lexer::TokenStream& tokens, int local,
+                                symbol::Namespace* sr, String expected_type) {
+    // walk down the left operands first, so long chains do not recurse
+    std::vector<int64> chain = {};
+    while (precedence(tree.nodes[idx].op) != 0) {
+        chain.push_back(idx);
+        idx = tree.nodes[idx].left;
+    }
+
+    const OperatorTree::Node& node = tree.nodes[idx];
+    lexer::TokenStream        part = tokens.slice(node.begin, 1, node.end);
+    sptr<AST>                 r    = nullptr;
+    if (node.op == lexer::Token::NONE) {
+        r = math::parse(part, local, sr, expected_type);
+    } else {
+        r = buildOperators(tree, node.left, tokens, local, sr, "@unknown");
+        if (r == nullptr) {
+            parser::error("Expression expected",
+                          part.slice(1, 1, 1),
+                          "Expected espression of type \e[1m"s + expected_type + "\e[0m after " +
+                              (node.op == lexer::Token::NOT ? '!' : '~'),
+                          111);
+            r = parser::make<AST>();
+        } else if (node.op == lexer::Token::NOT) {
+            r = parser::make<NotAST>(r, part);
+        } else {
+            r = parser::make<NegAST>(r, part);
+        }
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); it++) {
+        const OperatorTree::Node& op  = tree.nodes[*it];
+        uint64                    at  = tree.nodes[op.left].end;
+        lexer::TokenStream        all = tokens.slice(op.begin, 1, op.end);
+        if (r == nullptr) {
+            parser::error("Expression expected",
+                          tokens.slice(op.begin, 1, at),
+                          "Expected espression of type \e[1m"s + expected_type + "\e[0m",
+                          111);
+            r = parser::make<AST>();
+            continue;
+        }
+        sptr<AST> right = buildOperators(tree, op.right, tokens, local, sr, expected_type);
+        if (right == nullptr) {
+            parser::error("Expression expected",
+                          tokens.slice(at + 1, 1, op.end),
+                          "Expected espression of type \e[1m"s + expected_type + "\e[0m",
+                          111);
+            r = parser::make<AST>();
+            continue;
+        }
+        r = binaryOperator(op.op, r, right, all);
+    }
+    return r;
+}
+
+sptr<AST> math::parse_operators(PARSER_FN_PARAM) {
+    OperatorTree tree;
+    if (!tree.build(tokens)) { return nullptr; }
+    DEBUGT(2, "math::parse_operators", &tokens);
+    return buildOperators(tree, tree.nodes.size() - 1, tokens, local, sr, expected_type);
+}
+
 sptr<AST> math::parse(lexer::TokenStream tokens, int local, symbol::Namespace* sr, String expected_type) {
     DEBUGT(2, "math::parse", &tokens);
+    parser::countExpression(tokens, expected_type);
+    if (sptr<AST> r = parse_operators(tokens, local, sr, expected_type)) { return r; }
     return parser::parseOneOf(tokens,
                               {parse_pt, IntLiteralAST::parse, FloatLiteralAST::parse, BoolLiteralAST::parse,
                                CharLiteralAST::parse, StringLiteralAST::parse, EmptyLiteralAST::parse, NullLiteralAST::parse, VarAccesAST::parse, VarSetAST::parse, ArrayIndexAST::parse, ArrayLiteralAST::parse,
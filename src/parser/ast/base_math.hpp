@@ -34,58 +34,82 @@ namespace math {
      * @return AST or nullptr if nothing matched
      */
     extern sptr<AST> parse_pt(PARSER_FN);
+
+    /**
+     * @brief parse an expression made of operators in one pass (precedence climbing). Gives the same AST as trying
+     * the operators' parse functions one by one, but takes linear time.
+     *
+     * @return AST or nullptr if the expression has no operators or is up to another parser
+     */
+    extern sptr<AST> parse_operators(PARSER_FN);
 } // namespace math
 
 /**
  * @class for generic expression ASTs
  */
 class ExpressionAST : public AST {
+    protected:
+        bool overflows = false; //> folding the value wrapped around, here or in an operand (@see NoWrapAST)
+
     public:
+        CLASS_KINDS(ADD, VAR_SET)
+
         ExpressionAST() {};
         virtual ~ExpressionAST() {};
+
+        /**
+         * @brief whether the value was folded and wrapped around on the way
+         */
+        inline bool wraps() const { return is_const && overflows; }
 };
 
 class DoubleOperandAST : public ExpressionAST {
     protected:
-        sptr<AST>                                                               left;  //> left operand
-        sptr<AST>                                                               right; //> right operand
-        lexer::Token::Type                                                      op               = lexer::Token::NONE;
-        String                                                                  op_view          = "";
-        std::map<std::tuple<CstType, CstType>, fsignal<String, String, String>> const_folding_fn = {};
+        sptr<AST>             left;  //> left operand
+        sptr<AST>             right; //> right operand
+        lexer::Token::Type    op       = lexer::Token::NONE;
+        String                op_view  = "";
+        mutable types::TypeId resolved = types::NO_TYPE; //> return type once asked for. Reset when forceType changes it
 
         String _str() const final;
 
     public:
+        CLASS_KINDS(ADD, LT)
+
         DoubleOperandAST() {};
         virtual ~DoubleOperandAST() {};
 
-        LLType  getLLType() const final;
-        CstType getCstType() const final;
-        void    forceType(CstType) final;
-        String  emitCST() const final;
+        LLType        getLLType() const final;
+        CstType       getCstType() const final;
+        types::TypeId getTypeId() const final;
+        void          forceType(CstType) final;
+        String        emitCST() const final;
 
         uint64 nodeSize() const final;
 };
 
 class UnaryOperandAST : public ExpressionAST {
     protected:
-        sptr<AST>                                  left; //> left operand
-        lexer::Token::Type                         op               = lexer::Token::NONE;
-        String                                     op_view          = "";
-        std::map<CstType, fsignal<String, String>> const_folding_fn = {};
+        sptr<AST>             left; //> left operand
+        lexer::Token::Type    op       = lexer::Token::NONE;
+        String                op_view  = "";
+        mutable types::TypeId resolved = types::NO_TYPE; //> return type once asked for
 
         String _str() const final;
 
     public:
+        CLASS_KINDS(NOT, NEG)
+
         UnaryOperandAST() {};
         virtual ~UnaryOperandAST() {};
 
         // fwd declarations. @see @class AST
 
-        LLType  getLLType() const final;
-        CstType getCstType() const final;
-        void    forceType(CstType) final;
-        String  emitCST() const final;
+        LLType        getLLType() const final;
+        CstType       getCstType() const final;
+        types::TypeId getTypeId() const final;
+        void          forceType(CstType) final;
+        String        emitCST() const final;
 
         uint64 nodeSize() const final;
 };
@@ -95,6 +119,8 @@ class UnaryOperandAST : public ExpressionAST {
  */
 class AddAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(ADD)
+
         AddAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~AddAST();
 
@@ -115,6 +141,8 @@ class AddAST : public DoubleOperandAST {
  */
 class SubAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(SUB)
+
         SubAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~SubAST();
 
@@ -128,6 +156,8 @@ class SubAST : public DoubleOperandAST {
  */
 class MulAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(MUL)
+
         MulAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~MulAST();
 
@@ -148,6 +178,8 @@ class MulAST : public DoubleOperandAST {
  */
 class DivAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(DIV)
+
         DivAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~DivAST();
 
@@ -161,6 +193,8 @@ class DivAST : public DoubleOperandAST {
  */
 class ModAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(MOD)
+
         ModAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~ModAST();
 
@@ -174,6 +208,8 @@ class ModAST : public DoubleOperandAST {
  */
 class PowAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(POW)
+
         PowAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~PowAST();
 
@@ -194,6 +230,8 @@ class PowAST : public DoubleOperandAST {
  */
 class LorAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(LOR)
+
         LorAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~LorAST();
 
@@ -214,6 +252,8 @@ class LorAST : public DoubleOperandAST {
  */
 class LandAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(LAND)
+
         LandAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~LandAST();
 
@@ -234,6 +274,8 @@ class LandAST : public DoubleOperandAST {
  */
 class OrAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(OR)
+
         OrAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~OrAST() = default;
 
@@ -254,6 +296,8 @@ class OrAST : public DoubleOperandAST {
  */
 class AndAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(AND)
+
         AndAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~AndAST() = default;
 
@@ -274,6 +318,8 @@ class AndAST : public DoubleOperandAST {
  */
 class XorAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(XOR)
+
         XorAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~XorAST() = default;
 
@@ -294,6 +340,8 @@ class XorAST : public DoubleOperandAST {
  */
 class EqAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(EQ)
+
         EqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~EqAST() = default;
 
@@ -314,6 +362,8 @@ class EqAST : public DoubleOperandAST {
  */
 class NeqAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(NEQ)
+
         NeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~NeqAST() = default;
 
@@ -334,6 +384,8 @@ class NeqAST : public DoubleOperandAST {
  */
 class GeqAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(GEQ)
+
         GeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~GeqAST() = default;
 
@@ -354,6 +406,8 @@ class GeqAST : public DoubleOperandAST {
  */
 class LeqAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(LEQ)
+
         LeqAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~LeqAST() = default;
 
@@ -374,6 +428,8 @@ class LeqAST : public DoubleOperandAST {
  */
 class GtAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(GT)
+
         GtAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~GtAST() = default;
 
@@ -394,6 +450,8 @@ class GtAST : public DoubleOperandAST {
  */
 class LtAST : public DoubleOperandAST {
     public:
+        CLASS_KIND(LT)
+
         LtAST(sptr<AST> left, sptr<AST> right, lexer::TokenStream tokens);
         virtual ~LtAST() = default;
 
@@ -414,6 +472,8 @@ class LtAST : public DoubleOperandAST {
  */
 class NotAST : public UnaryOperandAST {
     public:
+        CLASS_KIND(NOT)
+
         NotAST(sptr<AST> inner, lexer::TokenStream tokens);
         virtual ~NotAST() = default;
 
@@ -434,6 +494,8 @@ class NotAST : public UnaryOperandAST {
  */
 class NegAST : public UnaryOperandAST {
     public:
+        CLASS_KIND(NEG)
+
         NegAST(sptr<AST> inner, lexer::TokenStream tokens);
         virtual ~NegAST() = default;
 
@@ -457,6 +519,8 @@ class CastAST : public ExpressionAST {
         sptr<AST> type;
 
     public:
+        CLASS_KIND(CAST)
+
         CastAST(sptr<AST> from, sptr<AST> type, lexer::TokenStream tokens);
         virtual ~CastAST() {};
 
@@ -488,7 +552,10 @@ class CheckAST : public ExpressionAST {
         sptr<AST> of;
 
     public:
+        CLASS_KIND(CHECK)
+
         CheckAST(sptr<AST> of, lexer::TokenStream tokens) {
+            kind         = KIND;
             this->of     = of;
             this->tokens = tokens;
         }
@@ -527,7 +594,10 @@ class NoWrapAST : public ExpressionAST {
         String _str() const { return "<NOWRAP "s + str(of.get()) + ">"; }
 
     public:
+        CLASS_KIND(NOWRAP)
+
         NoWrapAST(sptr<AST> of, lexer::TokenStream tokens) {
+            kind         = KIND;
             this->of     = of;
             this->tokens = tokens;
         }
@@ -563,6 +633,8 @@ class AddrOfAST : public ExpressionAST {
         sptr<AST> of;
 
     public:
+        CLASS_KIND(ADDR_OF)
+
         AddrOfAST(sptr<AST> of);
         virtual ~AddrOfAST();
 
@@ -587,7 +659,10 @@ class ArrayIndexAST : public ExpressionAST {
         sptr<AST> idx;
 
     public:
+        CLASS_KIND(ARRAY_INDEX)
+
         ArrayIndexAST(lexer::TokenStream tokens, sptr<AST> of, sptr<AST> idx) {
+            kind         = KIND;
             this->of     = of;
             this->idx    = idx;
             this->tokens = tokens;
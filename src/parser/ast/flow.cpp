@@ -47,8 +47,55 @@ String SubBlockAST::emitLL(int* locc, String inp) const {
     return ret + inp;
 }
 
+/**
+ * @brief a statement parser and the statements it can accept. It returns nullptr for any other statement without
+ * issuing anything
+ */
+struct StatementParser {
+        PARSER_FN_NO_DEFAULT fn;
+        lexer::Token::Type   first;     //> token the statement has to start with, NONE for any
+        bool                 needs_end; //> whether the statement has to end on a ';'
+};
+
+/**
+ * @brief all statement parsers in the order they are tried
+ */
+static const StatementParser statement_parsers[] = {
+    {NamespaceAST::parse, lexer::Token::NAMESPACE, false},
+    {VarInitlAST::parse,  lexer::Token::NONE,      true },
+    {VarDeclAST::parse,   lexer::Token::NONE,      true },
+    {parseStatement,      lexer::Token::NONE,      true },
+    {EnumAST::parse,      lexer::Token::ENUM,      false},
+    {IfAST::parse,        lexer::Token::IF,        false},
+    {ReturnAST::parse,    lexer::Token::RETURN,    false},
+    {FuncDefAST::parse,   lexer::Token::NONE,      false},
+    {DeleteAST::parse,    lexer::Token::DELETE,    false},
+    {ImportAST::parse,    lexer::Token::NONE,      false}, // also reports 'import' in the middle of statements
+};
+
+/**
+ * @brief get the statement parsers that can accept a statement starting with first, in the order they are tried.
+ * The lists are built once for every token type, so a statement only goes to the parsers that can accept it
+ */
+static const std::vector<PARSER_FN_NO_DEFAULT>& statementParsers(lexer::Token::Type first, bool ends) {
+    static const auto table = [] {
+        std::vector<std::vector<PARSER_FN_NO_DEFAULT>> t(2 * (lexer::Token::X + 1));
+        for (uint64 type = 0; type <= lexer::Token::X; type++) {
+            for (bool e : {false, true}) {
+                for (const StatementParser& p : statement_parsers) {
+                    if ((p.first == lexer::Token::NONE || p.first == type) && (e || !p.needs_end)) {
+                        t[2 * type + e].push_back(p.fn);
+                    }
+                }
+            }
+        }
+        return t;
+    }();
+    return table[2 * first + ends];
+}
+
 sptr<AST> SubBlockAST::parse(PARSER_FN_PARAM) {
-    if (tokens.size() == 0) return share<AST>(new SubBlockAST (false));
+    if (tokens.size() == 0) return parser::make<SubBlockAST>(false);
     std::vector<sptr<AST>> contents;
     bool has_returned=false;
     sptr<AST> last_return = nullptr;
@@ -62,13 +109,13 @@ sptr<AST> SubBlockAST::parse(PARSER_FN_PARAM) {
         DEBUGT(2, "SubBlockAST::parse", &buffer);
         if (!(buffer.size() == 1 && buffer[0].type == lexer::Token::END_CMD)) {
             if (buffer.size() == 1 && buffer[0].type == lexer::Token::DOTDOTDOT) continue;
-            sptr<AST> expr = parser::parseOneOf(
-                buffer, {
-                            NamespaceAST::parse, VarInitlAST::parse,
-                            VarDeclAST::parse, parseStatement, EnumAST::parse, IfAST::parse, ReturnAST::parse, FuncDefAST::parse,
-                            DeleteAST::parse,
-                            ImportAST::parse
-                        }, local, sr, "void");
+            sptr<AST> expr = nullptr;
+            parser::stats.statements++;
+            for (const auto& fn : statementParsers(buffer.type(0), buffer.type(-1) == lexer::Token::END_CMD)) {
+                parser::stats.attempts++;
+                expr = fn(buffer, local, sr, "void");
+                if (expr != nullptr) break;
+            }
 
             if (expr == nullptr){
                 parser::error("Expected expression", buffer, "Expected a valid expression (Did you forget a ';'?)", 31);
@@ -82,9 +129,9 @@ sptr<AST> SubBlockAST::parse(PARSER_FN_PARAM) {
                     last_return = expr;
                     // check variables for usage
                     for (std::pair<String, std::vector<symbol::Reference*>> sr : sr->contents){
-                        if (sr.second.at(0) == dynamic_cast<symbol::Variable*>(sr.second.at(0))){
+                        if (isa<symbol::Variable>(sr.second.at(0))){
                             auto var = (symbol::Variable*)sr.second.at(0);
-                            fsignal<void, String, std::vector<lexer::Token>, String, uint32, String> warn_error = parser::error;
+                            fsignal<void, String, lexer::SourceRange, String, uint32, String> warn_error = parser::error;
                             if (var->isFree){
                                 warn_error = parser::warn;
                                 if (var->getVarName()[0] == '_'){continue;}
@@ -116,14 +163,14 @@ sptr<AST> SubBlockAST::parse(PARSER_FN_PARAM) {
                 contents.push_back(expr);
             }
             if(!unreachable.empty()){
-                parser::error("Unreachable code", {unreachable[0]->getTokens()[0], unreachable[unreachable.size()-1]->getTokens()[-1]}, "", 0);
+                parser::error("Unreachable code", lexer::SourceRange::span(unreachable[0]->getTokens(), unreachable[unreachable.size()-1]->getTokens()), "", 0);
                 parser::note(last_return->getTokens(),"because of this return statement",0);
             } 
         }
         tokens = split.after();
     }
 
-    auto b = share<SubBlockAST>(new SubBlockAST(has_returned));
+    auto b = parser::make<SubBlockAST>(has_returned);
     b->contents = contents;
     return b;
 }
@@ -141,7 +188,7 @@ sptr<AST> IfAST::parse(PARSER_FN_PARAM) {
         }
         if (!(tokens[-1].type == lexer::Token::BLOCK_CLOSE)) {
             parser::error("Expected Block close", {tokens[-1]},
-                          "Expected a '}' token after '"s + tokens[-1].value + "'", 0);
+                          "Expected a '}' token after '"s + String(tokens[-1].value) + "'", 0);
 
             return ERR;
         }
@@ -168,7 +215,7 @@ sptr<AST> IfAST::parse(PARSER_FN_PARAM) {
             ls.traceback(ls2);
         }
         
-        return share<AST>(new IfAST(block, condition, tokens, sb));
+        return parser::make<IfAST>(block, condition, tokens, sb);
     }
     
     return nullptr;
@@ -183,12 +230,12 @@ sptr<AST> ReturnAST::parse(PARSER_FN_PARAM){
                 parser::error("Expected ';'", {tokens[-1]}, "expected ';' at the end of statement",0);
                 return ERR;
             }
-            if ((symbol::Function*)sr == dynamic_cast<symbol::Function*>(sr) || sr->getName() == "Function"){
+            if (isa<symbol::Function>(sr) || sr->getName() == "Function"){
                 if (((symbol::Function*)sr)->getReturnType() != "void"){
                     parser::error("Type mismatch", tokens, "expected a return of type \e[0m"s + ((symbol::Function*)sr)->getReturnType() + "\e[0m got void",0);
                     return ERR;
                 }
-                return share<AST>(new ReturnAST(ERR, tokens));
+                return parser::make<ReturnAST>(ERR, tokens);
             } else {
                 parser::error("return not allowed", tokens, "return statements are not allowed in a block of type "s + sr->getName(),0);
                 return ERR;
@@ -200,7 +247,7 @@ sptr<AST> ReturnAST::parse(PARSER_FN_PARAM){
             parser::error("Expected ';'", {tokens[-1]}, "expected ';' at the end of statement",0);
             return ERR;
         }
-        if ((symbol::Function*)sr == dynamic_cast<symbol::Function*>(sr) || sr->getName() == "Function"){
+        if (isa<symbol::Function>(sr) || sr->getName() == "Function"){
 
             sptr<AST> expr = math::parse(tokens.slice(1, 1, -1), local, sr);
 
@@ -210,7 +257,7 @@ sptr<AST> ReturnAST::parse(PARSER_FN_PARAM){
             }
 
             expr->forceType(sr->getReturnType());
-            return share<AST>(new ReturnAST(expr, tokens));
+            return parser::make<ReturnAST>(expr, tokens);
         } else {
             parser::error("return not allowed", tokens, "return statements are not allowed in a block of type "s + sr->getName(),0);
             return ERR;
@@ -16,11 +16,14 @@ class SubBlockAST : public AST {
         String _str() const;
 
     public:
+        CLASS_KIND(SUB_BLOCK)
+
         std::vector<sptr<AST>> contents = {}; //> block comments
         symbol::Namespace*     parent   = nullptr;
         bool                   has_returned = false;
 
         SubBlockAST(bool has_returned) {
+            kind               = KIND;
             this->has_returned = has_returned;
         }
 
@@ -50,11 +53,14 @@ class SubBlockAST : public AST {
 
 class IfAST : public AST {
     public:
+        CLASS_KIND(IF)
+
         sptr<SubBlockAST> block;
         sptr<AST>         cond;
         symbol::Namespace* sb;
 
         IfAST(sptr<SubBlockAST> block, sptr<AST> cond, lexer::TokenStream t, symbol::Namespace* sb) {
+            kind        = KIND;
             tokens      = t;
             this->block = block;
             this->cond  = cond;
@@ -89,10 +95,13 @@ class IfAST : public AST {
 
 class ReturnAST : public AST {
     public:
+        CLASS_KIND(RETURN)
+
         sptr<AST> expr;
         CstType   type = "";
 
         ReturnAST(sptr<AST> expr, lexer::TokenStream tokens) {
+            kind         = KIND;
             this->expr   = expr;
             this->tokens = tokens;
         }
@@ -14,6 +14,7 @@
 #include "var.hpp"
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <sys/types.h>
 #include <tuple>
@@ -33,7 +34,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
     }
     String name = parse_name(split.before()); //> get function name
     if (name == "") {                         // something went wrong. Error checking is done in parse_name
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
 
     // parse arguments
@@ -45,7 +46,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
         lexer::TokenStream::Match m = t.rsplitStack({lexer::Token::COMMA});
         if (m.found() && (uint64) m == 0) {
             parser::error("Expression exptected", {t[m]}, "Expected an expression before ','", 31);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         } else {
             lexer::TokenStream        t2 = m.found() ? m.before() : t;
             lexer::TokenStream::Match m2 = t2.rsplitStack({lexer::Token::SET});
@@ -59,12 +60,12 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
                                   t2,
                                   "An optional argument needs to have a single argument name",
                                   0); // TODO: improve error message
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
                 sptr<AST> a = math::parse(m2.after(), local + 1, sr);
                 if (a == nullptr) {
                     parser::error("Expected Expression", m2.after(), "Expected a valid expression", 31);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
                 named_params[opt_name] = a;
 
@@ -80,7 +81,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
                 sptr<AST> a = math::parse(t2, local + 1, sr);
                 if (a == nullptr) {
                     parser::error("Expected Expression", t2, "Expected a valid expression", 31);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
                 params.push_back(a);
             }
@@ -95,7 +96,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
                       split.before(),
                       "A Funtion with name of '" + name + "' was not found in this scope",
                       26);
-        return sptr<AST>(new AST);
+        return parser::make<AST>();
     }
 
     // check for valid function
@@ -103,7 +104,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
     bool   matches = false;
     uint32 j       = 0;
     for (symbol::Reference* f : options) {
-        if ((symbol::Function*) f == dynamic_cast<symbol::Function*>(f)) {
+        if (isa<symbol::Function>(f)) {
             symbol::Function* ft = (symbol::Function*) f;
             if (ft->parameters.size() != params.size()) { continue; }
             for (uint32 i = 0; i < params.size(); i++) {
@@ -138,7 +139,7 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
         if (options.size() > 0) {
             appendix = "Valid options are: \n";
             for (symbol::Reference* f : options) {
-                if ((symbol::Function*) f == dynamic_cast<symbol::Function*>(f)) {
+                if (isa<symbol::Function>(f)) {
                     symbol::Function* ft  = (symbol::Function*) f;
                     appendix             += "\e[1m" + ft->getLoc() + "(";
                     bool has_parameters   = false;
@@ -160,13 +161,14 @@ sptr<AST> FuncCallAST::parse(PARSER_FN_PARAM) {
                       "\e[1m"s + options[0]->getLoc() + "(" + paramlist + ")\e[0m is not defined",
                       26,
                       appendix);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
 
     // TODO check for ambigous functions
 
     symbol::Function* p = (symbol::Function*) (*sr)[name][j];
-    return share<AST>(new FuncCallAST(name, params, p));
+    FuncDefAST::parseLazily(p);
+    return parser::make<FuncCallAST>(name, params, p);
 }
 
 String FuncCallAST::emitLL(int* locc, String inp) const {
@@ -209,12 +211,16 @@ sptr<AST> ArrayLengthAST::parse(PARSER_FN_PARAM) {
         if (after.size() != 3) { return nullptr; }
         if (after[0].type != lexer::Token::ID || after[0].value != "len") { return nullptr; }
         if (after[1].type != lexer::Token::OPEN || after[2].type != lexer::Token::CLOSE) { return nullptr; }
-        sptr<AST> from = math::parse(m.before(), local, sr);
+        // only arrays have len(), anything else is left to FuncCallAST. Parsing the receiver may consume it, so
+        // that is undone if it is no array
+        parser::Checkpoint checkpoint;
+        sptr<AST>          from = math::parse(m.before(), local, sr);
         if (from == nullptr) { return nullptr; }
         if (from->getCstType().size() > 1 && from->getCstType().substr(from->getCstType().size()-2) == "[]"){
 
-            return share<AST>(new ArrayLengthAST(from, tokens.slice(m, 1, tokens.size())));
+            return parser::make<ArrayLengthAST>(from, tokens.slice(m, 1, tokens.size()));
         }
+        checkpoint.rollback();
     }
     return nullptr;
 }
@@ -238,6 +244,8 @@ bool ArrayLengthAST::isConst() {
     return from->is_const;
 }
 
+thread_local std::vector<FuncDefAST::Deferred>* FuncDefAST::deferred = nullptr;
+
 sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
     DEBUG(4, "Trying \e[1mFuncDefAST::parse\e[0m");
     if (tokens.size() < 3) { return nullptr; }
@@ -249,7 +257,7 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
         lexer::TokenStream        t2    = tokens.slice(m, 1, tokens.size());
         lexer::TokenStream::Match start = t2.rsplitStack({lexer::Token::BLOCK_OPEN});
         if (!start.found()) { return nullptr; }
-        String name = t[-1].value;
+        String name = String(t[-1].value);
         parser::checkName(name, t[-1]);
 
         DEBUG(2, "FuncDefAST::parse");
@@ -264,8 +272,8 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
         DEBUGT(3, "\ttokens: ", &tokens);
         if (start.before()[-1].type != lexer::Token::CLOSE) { return ERR; }
 
-        std::map<String, std::pair<std::vector<lexer::Token>, sptr<AST>>> parameters = {}; //> List of all parameters
-        std::map<String, std::tuple<std::vector<lexer::Token>, sptr<AST>, sptr<AST>>> named_parameters =
+        std::map<String, std::pair<lexer::SourceRange, sptr<AST>>> parameters = {}; //> List of all parameters
+        std::map<String, std::tuple<lexer::SourceRange, sptr<AST>, sptr<AST>>> named_parameters =
             {}; //> List of all nonpositional parameters
 
         // parse function parameters
@@ -281,7 +289,7 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
                 param        = m.after();
             } else {
                 param_buffer = param;
-                param.tokens = {};
+                param = lexer::TokenStream({});
             }
             if (param_buffer.empty()) { continue; }
             m = param_buffer.rsplitStack({lexer::Token::SET});
@@ -332,7 +340,7 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
                 }
                 default_value->forceType(type->getCstType());
 
-                named_parameters[pname] = std::tuple(param_buffer.tokens, default_value, type);
+                named_parameters[pname] = std::tuple(lexer::SourceRange(param_buffer), default_value, type);
                 
             } else {
                 if (param_buffer[-1].type != lexer::Token::ID) {
@@ -356,11 +364,11 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
                 if (type == nullptr) {
                     parser::error("Type expected",
                                   {param_buffer.slice(0, 1, -1)},
-                                  "Expected a type before '"s + param_buffer[-1].value + "'",
+                                  "Expected a type before '"s + String(param_buffer[-1].value) + "'",
                                   0);
                     return ERR;
                 }
-                parameters[pname] = std::pair(param_buffer.tokens, type);
+                parameters[pname] = std::pair(lexer::SourceRange(param_buffer), type);
 
                 if (!(last_named == nullToken)) {
                     parser::error("positional parameter after named parameter",
@@ -376,7 +384,6 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
 
         lexer::TokenStream block = start.after();
         if (block[-1].type != lexer::Token::BLOCK_CLOSE) { return ERR; }
-        DEBUG(3, "\tparsing block...");
 
         // TODO check for existing functions
 
@@ -400,42 +407,71 @@ sptr<AST> FuncDefAST::parse(PARSER_FN_PARAM) {
             parser::warn("Wrong casing", {t[-1]}, "Function name should be pascalCase", 16);
         }
 
-        sptr<AST> block_contents = SubBlockAST::parse(block.slice(0, 1, -1), local + 1, f);
-
-        // check variables for usage
-        for (std::pair<String, std::vector<symbol::Reference*>> sr : f->contents){
-            if (sr.second.at(0) == dynamic_cast<symbol::Variable*>(sr.second.at(0))){
-                auto var = (symbol::Variable*)sr.second.at(0);
-                fsignal<void, String, std::vector<lexer::Token>, String, uint32, String> warn_error = parser::error;
-                if (var->isFree){
-                    warn_error = parser::warn;
-                    if (var->getVarName()[0] == '_'){continue;}
-                }
-                if (var->used == symbol::Variable::PROVIDED && !(var->isStatic)){
-                    warn_error("Type linearity violated", var->last, "This variable was provided, but never consumed." + (var->isFree ? "\nIf this was intended, prefix it with an '_'."s : ""s), 0, "");
-                }
-                if (var->used == symbol::Variable::CONSUMED && var->isStatic && !var->isFree){
-                    warn_error("Type linearity violated", var->last, "This static variable was consumed, but never provided.", 0, "");
-                }
-                if (var->used == symbol::Variable::UNINITIALIZED){
-                    parser::warn("Unused Variable", var->tokens, "This variable was declared, but never used" + (var->isFree ? "\nIf this was intended, prefix it with an '_'."s : ""s), 0);
-                }
-            }
-        }
-
-        if (!cast2(block_contents, SubBlockAST)->has_returned){
-            if (type->getCstType() != "void"){
-                parser::error("Unreturned function", tokens, "This function does not return in all cases", 0);
-            }
+        auto def = parser::make<FuncDefAST>(name, cast2(type, TypeAST), parameters, f, block.slice(0, 1, -1), local, tokens);
+        if (deferred != nullptr) {
+            deferred->push_back({def, parser::held()});
+        } else {
+            def->parseBody();
         }
-
-        return share<AST>(new FuncDefAST(name,
-        cast2(type, TypeAST) , parameters, f, cast2(block_contents, SubBlockAST)));
+        return def;
     }
     
     return nullptr;
 }
 
+void FuncDefAST::parseBody() {
+    DEBUG(3, "\tparsing block...");
+    sptr<AST> block_contents = SubBlockAST::parse(body, local + 1, fn);
+
+    // check variables for usage
+    for (std::pair<String, std::vector<symbol::Reference*>> sr : fn->contents){
+        if (isa<symbol::Variable>(sr.second.at(0))){
+            auto var = (symbol::Variable*)sr.second.at(0);
+            fsignal<void, String, lexer::SourceRange, String, uint32, String> warn_error = parser::error;
+            if (var->isFree){
+                warn_error = parser::warn;
+                if (var->getVarName()[0] == '_'){continue;}
+            }
+            if (var->used == symbol::Variable::PROVIDED && !(var->isStatic)){
+                warn_error("Type linearity violated", var->last, "This variable was provided, but never consumed." + (var->isFree ? "\nIf this was intended, prefix it with an '_'."s : ""s), 0, "");
+            }
+            if (var->used == symbol::Variable::CONSUMED && var->isStatic && !var->isFree){
+                warn_error("Type linearity violated", var->last, "This static variable was consumed, but never provided.", 0, "");
+            }
+            if (var->used == symbol::Variable::UNINITIALIZED){
+                parser::warn("Unused Variable", var->tokens, "This variable was declared, but never used" + (var->isFree ? "\nIf this was intended, prefix it with an '_'."s : ""s), 0);
+            }
+        }
+    }
 
+    if (!cast2(block_contents, SubBlockAST)->has_returned){
+        if (fn->getReturnType() != "void"){
+            parser::error("Unreturned function", tokens, "This function does not return in all cases", 0);
+        }
+    }
+    contents = cast2(block_contents, SubBlockAST);
+}
 
+void FuncDefAST::parseLater(sptr<FuncDefAST> def) {
+    std::lock_guard<std::mutex> lock(def->fn->definition_lock);
+    def->fn->definition = def;
+}
 
+void FuncDefAST::parseLazily(symbol::Function* fn) {
+    sptr<AST> def = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(fn->definition_lock);
+        std::swap(def, fn->definition);
+    }
+    if (def == nullptr) { return; }
+
+    // nested definitions are parsed right away, even if the function is used while declarations are parsed. The body
+    // is parsed only once, so a checkpoint around the use (e.g. of f().len()) must not roll it back
+    std::vector<Deferred>* outer = deferred;
+    deferred                     = nullptr;
+    {
+        parser::Escape escape;
+        cast2(def, FuncDefAST)->parseBody();
+    }
+    deferred = outer;
+}
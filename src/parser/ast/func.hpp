@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../lexer/lexer.hpp"
+#include "../errors.hpp"
 #include "../symboltable.hpp"
 #include "ast.hpp"
 #include "base_math.hpp"
@@ -16,7 +17,10 @@ class FuncCallAST : public ExpressionAST {
         std::vector<sptr<AST>> params;
 
     public:
+        CLASS_KIND(FUNC_CALL)
+
         FuncCallAST(std::string name, std::vector<sptr<AST>> params, symbol::Function* f) {
+            kind         = KIND;
             this->name   = name;
             this->params = params;
             this->fn     = f;
@@ -43,7 +47,10 @@ class ArrayLengthAST : public ExpressionAST {
         sptr<AST> from;
 
     public:
+        CLASS_KIND(ARRAY_LENGTH)
+
         ArrayLengthAST(sptr<AST> from, lexer::TokenStream tokens) {
+            kind         = KIND;
             this->from   = from;
             this->tokens = tokens;
         }
@@ -67,20 +74,39 @@ class FuncDefAST : public AST {
         String                                                            name;
         symbol::Function*                                                 fn       = nullptr;
         sptr<SubBlockAST>                                                 contents = nullptr;
-        std::map<String, std::pair<std::vector<lexer::Token>, sptr<AST>>> params;
+        std::map<String, std::pair<lexer::SourceRange, sptr<AST>>> params;
         sptr<TypeAST>                                                     return_type = nullptr;
+        lexer::TokenStream body  = lexer::TokenStream({}); //> the body's tokens, without the braces
+        int                local = 0;                      //> depth of the definition
 
     public:
+        CLASS_KIND(FUNC_DEF)
+
+        /**
+         * @struct Deferred a definition whose body is parsed later and the diagnostics held back before it
+         */
+        struct Deferred {
+                sptr<FuncDefAST> def;
+                parser::Held     at; //> held back diagnostics when the body would have been parsed
+        };
+
+        static thread_local std::vector<Deferred>* deferred; //> while set, definitions only declare their function and are added here
+
         FuncDefAST(std::string                                                       name,
                    sptr<TypeAST>                                                     return_type,
-                   std::map<String, std::pair<std::vector<lexer::Token>, sptr<AST>>> params,
+                   std::map<String, std::pair<lexer::SourceRange, sptr<AST>>> params,
                    symbol::Function*                                                 f,
-                   sptr<SubBlockAST>                                                 block) {
-            this->contents    = block;
+                   lexer::TokenStream                                                body,
+                   int                                                               local,
+                   lexer::TokenStream                                                tokens) {
+            kind              = KIND;
             this->name        = name;
             this->params      = params;
             this->fn          = f;
             this->return_type = return_type;
+            this->body        = body;
+            this->local       = local;
+            this->tokens      = tokens;
         }
 
         virtual bool isConst() { return false; } // do constant folding or not
@@ -97,7 +123,9 @@ class FuncDefAST : public AST {
                 has_param  = true;
             }
             if (has_param) { r += "\b"; }
-            r += "){\n" + intab(contents->emitCST()) + "\n}";
+            r += ")";
+            if (contents == nullptr) { return r + ";"; } // body was never parsed (@see parseLazily)
+            r += "{\n" + intab(contents->emitCST()) + "\n}";
             return r;
         }
 
@@ -107,5 +135,21 @@ class FuncDefAST : public AST {
 
         virtual void forceType(String) {}
 
+        /**
+         * @brief parse the body of the declared function and check its variables. It only touches the function's
+         * own scope, so bodies of different functions can be parsed at the same time
+         */
+        void parseBody();
+
+        /**
+         * @brief keep the body of a deferred definition unparsed until its function is used. @see parseLazily
+         */
+        static void parseLater(sptr<FuncDefAST> def);
+
+        /**
+         * @brief parse the body of a function if it was kept unparsed. Only the first call parses it
+         */
+        static void parseLazily(symbol::Function* fn);
+
         static sptr<AST> parse(PARSER_FN);
 };
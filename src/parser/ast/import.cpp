@@ -18,7 +18,7 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
     if (tokens.size() == 1 && tokens[0].type == lexer::Token::IMPORT) {
         parser::error("Expected name", {tokens[0]},
                                   "Exptected a module name after 'import'", 76);
-                        return share<AST>(new AST);
+                        return parser::make<AST>();
     }
     if (tokens.size() < 2)
         return nullptr;
@@ -26,7 +26,7 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
         uint32 i2 = 0;
         auto buffer = tokens.slice(1, 1, tokens.size());
         lexer::Token::Type last = lexer::Token::SUBNS;
-        for (lexer::Token a : buffer.tokens){
+        for (lexer::Token a : buffer){
             if (last == lexer::Token::SUBNS && (a.type == lexer::Token::DOTDOT || a.type == lexer::Token::ID)){
             } else if (a.type == lexer::Token::SUBNS &&
                        (last == lexer::Token::DOTDOT ||
@@ -43,19 +43,19 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
                               lexer::Token::Type::END_CMD)) {
                             parser::error("Expected End-of-Statement", {buffer[i2+2]},
                                   "Expected a ';'", 30);
-                            return share<AST>(new AST);
+                            return parser::make<AST>();
                         }
-                        String as = buffer[i2+1].value;
+                        String as = String(buffer[i2+1].value);
                         break;
                     } else {
                         parser::error("Expected Symbol", {buffer[i2+1]},
                                   "Exptected a name after 'as'", 30);
-                        return share<AST>(new AST);
+                        return parser::make<AST>();
                     }
                 } else {
                     parser::error("Expected Symbol", {a},
                                   "Exptected a name after 'as'", 30);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
             }
             else if ((last == lexer::Token::DOTDOT || last == lexer::Token::ID) && a.type == lexer::Token::Type::IN){
@@ -75,13 +75,13 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
                             buffer.slice(i2 + 2, 1, buffer.size() - 2),
                             "Expected a valid list of identifiers seperated with commas",
                             0); // TODO make this error better
-                        return share<AST>(new AST);
+                        return parser::make<AST>();
                     }
                 }
                 else {
                     parser::error("Expected Block Open", {a},
                                   "Exptected a '{ after ':'", 51);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
             }
             else if (last == lexer::Token::SUBNS && a.type == lexer::Token::Type::MUL){
@@ -91,7 +91,7 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
                 } else {
                     parser::error("Import-all must be at line End", {a},
                                   "import-all must be in format 'import my::nice::module::*;'", 51);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
             }
             else {
@@ -100,12 +100,12 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
                                   lexer::getTokenName(a.type) +
                                   " Token in import statement",
                               76);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             last = a.type; i2++;
         }
 
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
 
     for (uint32 i = 0; i < tokens.size() - 1; i++) {
@@ -113,7 +113,7 @@ sptr<AST> ImportAST::parse(PARSER_FN_PARAM) {
             parser::error(
                 "Unexpected import", {tokens[i]},
                 "'import' is expected to be the first token in a line.", 75);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
     }
     
@@ -16,7 +16,8 @@
 #include "base_math.hpp"
 
 #include <cstdint>
-#include <regex>
+#include <cstdio>
+#include <initializer_list>
 #include <string>
 #include <vector>
 
@@ -30,10 +31,29 @@ bool StringIntBiggerThan(String a, String b) {
     return false;
 }
 
-IntLiteralAST::IntLiteralAST(int bits, String value, bool tsigned, lexer::TokenStream tokens) {
+/**
+ * @brief get the size of a number type from its name
+ *
+ * @param type the type's name
+ * @param prefix the name of the type without its size, like "int"
+ * @param sizes the sizes the type comes in
+ *
+ * @return the size in bits or 0 if type is no prefix followed by one of sizes
+ */
+static int typeBits(const String& type, const String& prefix, std::initializer_list<int> sizes) {
+    if (type.compare(0, prefix.size(), prefix) != 0) { return 0; }
+    for (int size : sizes) {
+        if (type.compare(prefix.size(), String::npos, std::to_string(size)) == 0) { return size; }
+    }
+    return 0;
+}
+
+IntLiteralAST::IntLiteralAST(int bits, String value, bool tsigned, lexer::Literal literal, lexer::TokenStream tokens) {
+    kind          = KIND;
     this->bits    = bits;
     this->value   = value;
     this->tsigned = tsigned;
+    this->literal = literal;
     this->tokens  = tokens;
 
     // if constant is too big for (u)int32 upgrade to uint64
@@ -63,12 +83,12 @@ sptr<AST> IntLiteralAST::parse(PARSER_FN_PARAM) {
     DEBUG(4, "Trying \e[1mIntLiteralAST::parse\e[0m");
     if (tokens.size() < 1 || tokens.size() > 2) { return nullptr; }
     if (tokens[0].type == lexer::Token::Type::INT) {
-        return share<AST>(new IntLiteralAST(32, tokens[0].value, false, tokens));
+        return parser::make<IntLiteralAST>(32, String(tokens[0].value), false, tokens.literal(0), tokens);
     } else if (tokens[0].type == lexer::Token::Type::HEX) {
-        return share<AST>(new IntLiteralAST(32, tokens[0].value, false, tokens));
+        return parser::make<IntLiteralAST>(32, String(tokens[0].value), false, tokens.literal(0), tokens);
     } else if ((tokens[0].type == lexer::Token::Type::SUB || tokens[0].type == lexer::Token::Type::NEC) &&
                tokens.size() == 2 && tokens[1].type == lexer::Token::Type::INT) {
-        return share<AST>(new IntLiteralAST(32, "-"s + tokens[1].value, true, tokens));
+        return parser::make<IntLiteralAST>(32, "-"s + String(tokens[1].value), true, tokens.literal(1), tokens);
     }
 
     // TODO parse binary integers
@@ -76,39 +96,37 @@ sptr<AST> IntLiteralAST::parse(PARSER_FN_PARAM) {
 }
 
 void IntLiteralAST::forceType(String type) {
-    std::regex r("u?int(8|16|32|64|128)");
-    bool       expected_int = std::regex_match(type, r);
-    if (expected_int || type == "usize" || type == "ssize") {
-        bool sig  = type[0] != 'u';
-        int  bits;
-        if (type == "usize" || type == "ssize") {
-            bits=64;
-        } else {
-            bits = std::stoi(type.substr(3 + (!sig), type.size()));
-        }
+    int bits = typeBits(type, type[0] == 'u' ? "uint" : "int", {8, 16, 32, 64, 128});
+    if (type == "usize" || type == "ssize") { bits = 64; }
+    if (bits != 0) {
+        bool sig = type[0] != 'u';
 
         if (value[0] == '-' && !sig) {
             parser::error("Sign mismatch",
-                          {tokens[0], tokens[1]},
+                          tokens,
                           "Found a signed value (expected \e[1m"s + type + "\e[0m)",
                           45);
         }
         tsigned    = sig;
         this->bits = bits;
 
-        // TODO fix this
-        // if (StringIntBiggerThan(value.substr(value[0] == '-'),
-        //                        std::to_string((1 << (bits - tsigned)) - (value[0] != '-')))) {
-        //    parser::warn("Integer too big", tokens,
-        //                 "trying to fit a number too big into "s + type + ". This will lead to information loss.",
-        //                 17);
-        //}
+        if (bits < 128) {
+            // the biggest value without its sign that fits, e.g. 128 for a negative int8
+            uint64 max = (UINT64_MAX >> (64 - bits + sig)) + (sig && value[0] == '-');
+            if (literal.overflow || literal.integer > max) {
+                parser::warn("Integer too big",
+                             tokens,
+                             "trying to fit a number too big into "s + type + ". This will lead to information loss.",
+                             17);
+            }
+        }
     } else if (type != "@unknown") {
         parser::error("Type mismatch", tokens, "expected a \e[1m"s + type + "\e[0m, found int", 17, "Caused by");
     }
 }
 
 BoolLiteralAST::BoolLiteralAST(String value, lexer::TokenStream tokens) {
+    kind         = KIND;
     this->value  = value;
     this->tokens = tokens;
     is_const     = true;
@@ -126,7 +144,7 @@ sptr<AST> BoolLiteralAST::parse(lexer::TokenStream tokens, int, symbol::Namespac
     DEBUG(4, "Trying \e[1mBoolLiteralAST::parse\e[0m");
     if (tokens.size() == 1) {
         if (tokens[0].value == "true" || tokens[0].value == "false") {
-            return share<AST>(new BoolLiteralAST(tokens[0].value, tokens));
+            return parser::make<BoolLiteralAST>(String(tokens[0].value), tokens);
         }
     }
     return nullptr;
@@ -139,6 +157,7 @@ void BoolLiteralAST::forceType(String type) {
 }
 
 FloatLiteralAST::FloatLiteralAST(int bits, String value, lexer::TokenStream tokens) {
+    kind         = KIND;
     this->bits   = bits;
     this->value  = value;
     this->tokens = tokens;
@@ -177,9 +196,9 @@ sptr<AST> FloatLiteralAST::parse(lexer::TokenStream tokens, int, symbol::Namespa
     if (tokens.size() < 2) { return nullptr; }
     if (tokens.size() > 3) { return nullptr; }
     if (tokens[0].type == lexer::Token::Type::ACCESS && tokens[1].type == lexer::Token::Type::INT) {
-        return share<AST>(new FloatLiteralAST(32, (sig ? String("-0.") : String("0.")) + tokens[1].value + "e00", t));
+        return parser::make<FloatLiteralAST>(32, (sig ? String("-0.") : String("0.")) + String(tokens[1].value) + "e00", t);
     } else if (tokens[0].type == lexer::Token::Type::INT && tokens[1].type == lexer::Token::Type::ACCESS) {
-        String val = (sig ? String("-") : String("")) + tokens[0].value + ".";
+        String val = (sig ? String("-") : String("")) + String(tokens[0].value) + ".";
         if (tokens.size() == 3) {
             if (tokens[2].type == lexer::Token::Type::INT) {
                 val += tokens[2].value;
@@ -188,16 +207,14 @@ sptr<AST> FloatLiteralAST::parse(lexer::TokenStream tokens, int, symbol::Namespa
             }
         }
         val += "0e00";
-        return share<AST>(new FloatLiteralAST(32, val, t));
+        return parser::make<FloatLiteralAST>(32, val, t);
     }
     return nullptr;
 }
 
 void FloatLiteralAST::forceType(String type) {
-    std::regex r("float(16|32|64|128)");
-    bool       expected_float = std::regex_match(type, r);
-    if (expected_float) {
-        int bits   = std::stoi(type.substr(5, type.size()));
+    int bits = typeBits(type, "float", {16, 32, 64, 128});
+    if (bits != 0) {
         this->bits = bits;
     } else if (type != "@unknown") {
         parser::error("Type mismatch",
@@ -208,9 +225,11 @@ void FloatLiteralAST::forceType(String type) {
     }
 }
 
-CharLiteralAST::CharLiteralAST(String value, lexer::TokenStream tokens) {
-    this->value  = value;
-    this->tokens = tokens;
+CharLiteralAST::CharLiteralAST(String value, lexer::Literal literal, lexer::TokenStream tokens) {
+    kind          = KIND;
+    this->value   = value;
+    this->literal = literal;
+    this->tokens  = tokens;
     is_const     = true;
 }
 
@@ -227,41 +246,29 @@ sptr<AST> CharLiteralAST::parse(lexer::TokenStream tokens, int, symbol::Namespac
                           tokens,
                           "This char value is empty. This is not supported. Did you mean '\\u0000' ?",
                           578);
-            return share<AST>(new AST());
-        }
-        std::regex r("'\\\\u[0-9a-fA-F][0-9a-fA-F][0-9a-fA-F][0-9a-fA-F]'");
-        std::regex r2("'\\\\(n|a|r|t|f|v|\\\\|'|\"|)'");
-        if (std::regex_match(tokens[0].value, r) || std::regex_match(tokens[0].value, r2) ||
-            tokens[0].value.size() == 3) {
-            // std::cout<<"skdskdl"<<std::endl;
-            return share<AST>(new CharLiteralAST(tokens[0].value, tokens));
+            return parser::make<AST>();
         }
+        lexer::Literal literal = tokens.literal(0);
+        if (literal.valid) { return parser::make<CharLiteralAST>(String(tokens[0].value), literal, tokens); }
         parser::error("Invalid char",
                       tokens,
                       "This char value is not supported. Chars are meant to hold only one character. Did you mean to "
                       "use \"Double quotes\" ?",
                       579);
-        return share<AST>(new AST());
+        return parser::make<AST>();
     }
     return nullptr;
 }
 
 String CharLiteralAST::getValue() const {
-    if (this->value == "'\\n'") { return "u0x000A"; }
-    if (this->value == "'\\t'") { return "u0x0009"; }
-    if (this->value == "'\\v'") { return "u0x000B"; }
-    if (this->value == "'\\f'") { return "u0x000C"; }
-    if (this->value == "'\\r'") { return "u0x000D"; }
-    if (this->value == "'\\a'") { return "u0x0007"; }
-    if (this->value == "'\\\"'") { return "u0x0022"; }
-    if (this->value == "'\\\\'") { return "u0x005C"; }
-    if (this->value == "'\\\''") { return "u0x0027"; }
-
-    if (this->value[1] == '\\' && this->value.size() == 8) {
-        return String("u0x") + this->value.substr(3, 2) + this->value.substr(5, 2);
+    if (literal.escape) {
+        // unicode escapes keep their digits as written
+        if (value.size() == 8) { return "u0x"s + value.substr(3, 4); }
+        char hex[8];
+        std::snprintf(hex, sizeof(hex), "u0x%04X", literal.code_point);
+        return hex;
     }
-
-    return std::to_string((uint16_t) this->value[1]);
+    return std::to_string(literal.code_point);
 }
 
 void CharLiteralAST::forceType(String type) {
@@ -275,6 +282,7 @@ void CharLiteralAST::forceType(String type) {
 }
 
 StringLiteralAST::StringLiteralAST(String value, lexer::TokenStream tokens) {
+    kind         = KIND;
     this->value  = value;
     this->tokens = tokens;
     is_const     = true;
@@ -284,7 +292,7 @@ sptr<AST> StringLiteralAST::parse(lexer::TokenStream tokens, int, symbol::Namesp
     DEBUG(4, "Trying \e[1mStringLiteralAST::parse\e[0m");
     if (tokens.size() != 1) { return nullptr; }
     if (tokens[0].type == lexer::Token::Type::STRING) {
-        return share<AST>(new StringLiteralAST(tokens[0].value, tokens));
+        return parser::make<StringLiteralAST>(String(tokens[0].value), tokens);
     }
     return nullptr;
 }
@@ -319,7 +327,7 @@ void StringLiteralAST::forceType(String type) {
 }
 
 sptr<AST> NullLiteralAST::parse(PARSER_FN_PARAM) {
-    if (tokens.size() == 1 && tokens[0].type == lexer::Token::NULV) { return share<AST>(new NullLiteralAST(tokens)); }
+    if (tokens.size() == 1 && tokens[0].type == lexer::Token::NULV) { return parser::make<NullLiteralAST>(tokens); }
 
     return nullptr;
 }
@@ -337,7 +345,7 @@ sptr<AST> EmptyLiteralAST::parse(PARSER_FN_PARAM) {
     DEBUG(4, "Trying \e[1mEmptyLiteralAST::parse\e[0m");
     if (tokens.size() != 2) { return nullptr; }
     if (tokens[0].type == lexer::Token::INDEX_OPEN && tokens[1].type == lexer::Token::INDEX_CLOSE) {
-        return share<AST>(new EmptyLiteralAST(tokens));
+        return parser::make<EmptyLiteralAST>(tokens);
     }
     return nullptr;
 }
@@ -368,7 +376,7 @@ sptr<AST> ArrayFieldMultiplierAST::parse(PARSER_FN_PARAM) {
         amount->forceType("usize");
 
         DEBUG(5, "\tDone!");
-        return share<AST>(new ArrayFieldMultiplierAST(tokens,content, amount));
+        return parser::make<ArrayFieldMultiplierAST>(tokens,content, amount);
     }
     return nullptr;
 }
@@ -409,7 +417,7 @@ sptr<AST> ArrayLiteralAST::parse(PARSER_FN_PARAM) {
             }
             contents.push_back(expr);
         }
-        return share<AST>(new ArrayLiteralAST(tokens, contents));
+        return parser::make<ArrayLiteralAST>(tokens, contents);
     }
     return nullptr;
 }
@@ -17,6 +17,8 @@ extern AST* parse_neg(std::vector<lexer::Token>, int local, symbol::Namespace* s
 
 class LiteralAST : public AST {
     public:
+        CLASS_KINDS(INT_LITERAL, ARRAY_LITERAL)
+
         virtual ~LiteralAST() {};
         virtual String getValue() const abstract;
 
@@ -24,14 +26,17 @@ class LiteralAST : public AST {
 };
 
 class IntLiteralAST : public LiteralAST {
-        int  bits    = 32;   //> Integer Bit size
-        bool tsigned = true; //> whether this integer is signed
+        int            bits    = 32;   //> Integer Bit size
+        bool           tsigned = true; //> whether this integer is signed
+        lexer::Literal literal = {};   //> the value without its sign, as decoded by the lexer
 
     protected:
         String _str() const { return "<Int: "s + value + " | " + std::to_string(bits) + ">"; }
 
     public:
-        IntLiteralAST(int bits, String value, bool tsigned, lexer::TokenStream tokens);
+        CLASS_KIND(INT_LITERAL)
+
+        IntLiteralAST(int bits, String value, bool tsigned, lexer::Literal literal, lexer::TokenStream tokens);
 
         virtual ~IntLiteralAST() {}
 
@@ -61,6 +66,8 @@ class BoolLiteralAST : public LiteralAST {
         String _str() const { return "<Bool: "s + value + ">"; }
 
     public:
+        CLASS_KIND(BOOL_LITERAL)
+
         BoolLiteralAST(String value, lexer::TokenStream tokens);
 
         virtual ~BoolLiteralAST() {}
@@ -93,6 +100,8 @@ class FloatLiteralAST : public LiteralAST {
         String _str() const { return "<Float: "s + value + " | " + std::to_string(bits) + ">"; }
 
     public:
+        CLASS_KIND(FLOAT_LITERAL)
+
         FloatLiteralAST(int bits, String value, lexer::TokenStream tokens);
 
         virtual ~FloatLiteralAST() {}
@@ -116,11 +125,15 @@ class FloatLiteralAST : public LiteralAST {
 };
 
 class CharLiteralAST : public LiteralAST {
+        lexer::Literal literal = {}; //> the char as decoded by the lexer
+
     protected:
         String _str() const { return "<Char: '"s + value + "'>"; }
 
     public:
-        CharLiteralAST(String value, lexer::TokenStream tokens);
+        CLASS_KIND(CHAR_LITERAL)
+
+        CharLiteralAST(String value, lexer::Literal literal, lexer::TokenStream tokens);
 
         virtual ~CharLiteralAST() {}
 
@@ -148,6 +161,8 @@ class StringLiteralAST : public LiteralAST {
         String _str() const { return "<String: \""s + value + "\">"; }
 
     public:
+        CLASS_KIND(STRING_LITERAL)
+
         StringLiteralAST(String value, lexer::TokenStream tokens);
 
         virtual ~StringLiteralAST() {}
@@ -179,7 +194,9 @@ class NullLiteralAST : public LiteralAST {
         CstType type = "";
 
     public:
-        NullLiteralAST(lexer::TokenStream tokens){this->tokens = tokens;}
+        CLASS_KIND(NULL_LITERAL)
+
+        NullLiteralAST(lexer::TokenStream tokens){kind = KIND; this->tokens = tokens;}
 
         virtual ~NullLiteralAST() {}
 
@@ -210,7 +227,9 @@ class EmptyLiteralAST : public LiteralAST {
         uint64 const_len = 0;
 
     public:
-        EmptyLiteralAST(lexer::TokenStream tokens){this->tokens = tokens; is_const = true;}
+        CLASS_KIND(EMPTY_LITERAL)
+
+        EmptyLiteralAST(lexer::TokenStream tokens){kind = KIND; this->tokens = tokens; is_const = true;}
 
         virtual ~EmptyLiteralAST() {}
 
@@ -242,7 +261,10 @@ class ArrayFieldMultiplierAST : public AST {
         sptr<AST> amount;
 
         public:
+        CLASS_KIND(ARRAY_FIELD_MULTIPLIER)
+
         ArrayFieldMultiplierAST(lexer::TokenStream tokens, sptr<AST> content, sptr<AST> amount) {
+            kind         = KIND;
             this->tokens = tokens;
             this->content = content;
             this->amount = amount;
@@ -276,8 +298,10 @@ class ArrayLiteralAST : public LiteralAST {
         std::vector<sptr<AST>> contents = {};
 
     public:
+        CLASS_KIND(ARRAY_LITERAL)
+
         uint64 const_len = 0;
-        ArrayLiteralAST(lexer::TokenStream tokens, std::vector<sptr<AST>> contents){this->tokens = tokens; this->contents=contents;}
+        ArrayLiteralAST(lexer::TokenStream tokens, std::vector<sptr<AST>> contents){kind = KIND; this->tokens = tokens; this->contents=contents;}
 
         virtual ~ArrayLiteralAST() {}
 
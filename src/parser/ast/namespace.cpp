@@ -46,30 +46,31 @@ sptr<AST> NamespaceAST::parse(PARSER_FN_PARAM){
         if (tokens[1].type == lexer::Token::Type::ID){
             if (!sr->ALLOWS_SUBCLASSES){
                 parser::error("Namespace not allowed", tokens, "A Block of type Namespace was not allowed in a Block of type "s + sr->getName(), 60);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
-            if ((*sr)[tokens[1].value].size() > 0){
-                parser::error("Name already known", tokens, "An id with the name of "s + tokens[1].value + "was already used", 60);
-                parser::note((*sr)[tokens[1].value][0]->tokens, "defined here:", 0);
-                return share<AST>(new AST);
+            String name = String(tokens[1].value);
+            if ((*sr)[name].size() > 0){
+                parser::error("Name already known", tokens, "An id with the name of "s + name + "was already used", 60);
+                parser::note((*sr)[name][0]->tokens, "defined here:", 0);
+                return parser::make<AST>();
             }
             if (tokens.size() < 4 || tokens[2].type != lexer::Token::Type::BLOCK_OPEN){
                 parser::error("Expected Block open", {tokens[1]}, "A '{' was expected after this token", 51);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             if (tokens[tokens.size()-1].type != lexer::Token::Type::BLOCK_CLOSE){
                 parser::error("Expected Block close", {tokens[tokens.size()-1]}, "A '}' was expected", 52);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
 
-            symbol::Namespace* ns = new symbol::Namespace(tokens[1].value);
+            symbol::Namespace* ns = new symbol::Namespace(name);
             ns->parent = sr;
-            sr->add(tokens[1].value, ns);
+            sr->add(name, ns);
             sptr<AST> a = parser::parseOneOf(tokens.slice(3,1,tokens.size()-1), {SubBlockAST::parse}, local+1, ns, "void");
 
-            if (a == nullptr) return share<AST>(new AST);
+            if (a == nullptr) return parser::make<AST>();
 
-            return sptr<AST>(new NamespaceAST(std::dynamic_pointer_cast<SubBlockAST>(a), ns));
+            return parser::make<NamespaceAST>(cast2(a, SubBlockAST), ns);
         }
         else {
             parser::error("Identifier expected", {tokens[0]}, "Expected an identifier after 'namespace'", 50);
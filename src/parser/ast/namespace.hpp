@@ -23,7 +23,9 @@ class NamespaceAST : public AST {
     String _str() const;
 
     public:
-    NamespaceAST(sptr<SubBlockAST> a, symbol::Namespace* ns){block = a; this->ns = ns;}
+        CLASS_KIND(NAMESPACE)
+
+    NamespaceAST(sptr<SubBlockAST> a, symbol::Namespace* ns){kind = KIND; block = a; this->ns = ns;}
     virtual bool isConst() {return false;} // do constant folding or not
     virtual ~NamespaceAST(){};
     virtual String emitLL(int* locc, String inp) const;
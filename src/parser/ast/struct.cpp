@@ -35,21 +35,21 @@ sptr<AST> EnumAST::parse(PARSER_FN_PARAM){
     if (tokens[0].type == lexer::Token::Type::ENUM){
         if (tokens.size() == 1){
             parser::error("Identifier expected", {tokens[0]}, "Expected an identifier after 'enum'", 50);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
         if (tokens[1].type == lexer::Token::ID){
-            String name = tokens[1].value;
+            String name = String(tokens[1].value);
             if (tokens.size() == 2){
                 parser::error("Expected Block Open", {tokens[1]}, "Expected a Block open after this token", 51);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             if (tokens[2].type != lexer::Token::Type::BLOCK_OPEN){
                 parser::error("Expected Block Open", {tokens[2]}, "Expected a Block open", 51);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             if (tokens[tokens.size()-1].type != lexer::Token::Type::BLOCK_CLOSE){
                 parser::error("Expected Block Close", {tokens[2]}, "Expected a Block close at the End of this statement", 52);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
 
             // TODO
@@ -59,12 +59,12 @@ sptr<AST> EnumAST::parse(PARSER_FN_PARAM){
             }
 
             sr->add(name, new symbol::Enum(name));
-            return share<AST>(new EnumAST(name, tokens));
+            return parser::make<EnumAST>(name, tokens);
 
         }
         else {
             parser::error("Identifier expected", {tokens[1]}, "Expected an identifier after 'enum'", 50);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
 
     }
@@ -8,12 +8,13 @@
 #include <vector>
 
 TypeAST::TypeAST(String name) {
+    kind       = KIND;
     this->name = name;
 }
 
 sptr<AST> TypeAST::parse(PARSER_FN_PARAM) {
     if (tokens.size() != 1) { return nullptr; }
-    if (tokens[0].type == lexer::Token::Type::ID) { return share<AST>(new TypeAST(tokens[0].value)); }
+    if (tokens[0].type == lexer::Token::Type::ID) { return parser::make<TypeAST>(String(tokens[0].value)); }
     return nullptr;
 }
 
@@ -22,6 +23,7 @@ sptr<AST> Type::parse(PARSER_FN_PARAM) {
 }
 
 OptionalTypeAST::OptionalTypeAST(sptr<TypeAST> t) {
+    kind       = KIND;
     this->type = t;
 }
 
@@ -33,12 +35,13 @@ sptr<AST> OptionalTypeAST::parse(PARSER_FN_PARAM) {
         if (! instanceOf(t, TypeAST)){
             return nullptr;
         }
-        return share<AST>(new OptionalTypeAST(std::dynamic_pointer_cast<TypeAST>(t)));
+        return parser::make<OptionalTypeAST>(cast2(t, TypeAST));
     }
     return nullptr;
 }
 
 ArrayTypeAST::ArrayTypeAST(sptr<TypeAST> t){
+    kind       = KIND;
     this->type = t;
 }
 
@@ -54,7 +57,7 @@ sptr<AST> ArrayTypeAST::parse(PARSER_FN_PARAM){
             parser::error("Type expected", tokens.slice(0, 1, -2), "expected a valid type", 0);
             return ERR;
         }
-        return share<AST>(new ArrayTypeAST(cast2(type, TypeAST)));
+        return parser::make<ArrayTypeAST>(cast2(type, TypeAST));
     }
     return nullptr;
 }
\ No newline at end of file
@@ -25,8 +25,11 @@ class TypeAST : public AST {
     String name = "";
 
     public:
+        static constexpr Kind KIND = TYPE;
+        CLASS_KINDS(TYPE, ARRAY_TYPE)
+
     TypeAST(String name);
-    TypeAST() = default;
+    TypeAST() {kind = KIND;}
     virtual bool isConst(){return false;} // do constant folding or not
     virtual ~TypeAST(){}
     virtual String emitLL(int*, String) const {return "";}
@@ -48,6 +51,8 @@ class OptionalTypeAST : public TypeAST {
     sptr<TypeAST> type;
 
     public:
+        CLASS_KIND(OPTIONAL_TYPE)
+
     OptionalTypeAST(sptr<TypeAST> type);
     virtual bool isConst(){return false;} // do constant folding or not
     virtual ~OptionalTypeAST(){}
@@ -70,6 +75,8 @@ class ArrayTypeAST : public TypeAST {
     sptr<TypeAST> type;
 
     public:
+        CLASS_KIND(ARRAY_TYPE)
+
     ArrayTypeAST(sptr<TypeAST> type);
     virtual bool isConst(){return false;} // do constant folding or not
     virtual ~ArrayTypeAST(){}
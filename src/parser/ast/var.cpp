@@ -10,6 +10,7 @@
 #include "literal.hpp"
 #include "type.hpp"
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -22,7 +23,7 @@ String parse_name(lexer::TokenStream tokens) {
         parser::error("Expected Symbol", {tokens[0]}, "module name or variable name expected", 30);
         return "null";
     }
-    for (lexer::Token t : tokens.tokens) {
+    for (lexer::Token t : tokens) {
         if (last == lexer::Token::Type::SUBNS && t.type == lexer::Token::Type::ID) {
             name += t.value;
         } else if (last == lexer::Token::Type::ID && t.type == lexer::Token::Type::SUBNS) {
@@ -45,6 +46,7 @@ sptr<AST> parseStatement(lexer::TokenStream tokens, int local, symbol::Namespace
 }
 
 VarDeclAST::VarDeclAST(String name, sptr<AST> type, symbol::Variable* v) {
+    kind       = KIND;
     this->name = name;
     this->type = type;
     this->v    = v;
@@ -123,13 +125,13 @@ sptr<AST> VarDeclAST::parse(PARSER_FN_PARAM) {
                                   25);
                 }
 
-                symbol::Variable* v = new symbol::Variable(name, type->getCstType(), tokens2.tokens, sr);
+                symbol::Variable* v = new symbol::Variable(name, type->getCstType(), tokens2, sr);
                 v->isConst          = m & parser::Modifier::CONST;
                 v->isMutable        = m & parser::Modifier::MUTABLE;
                 v->isStatic         = m & parser::Modifier::STATIC;
                 sr->add(name, v);
                 if (parser::isAtomic(type->getCstType())) { v->isFree = true; }
-                return sptr<AST>(new VarDeclAST(name, type, v));
+                return parser::make<VarDeclAST>(name, type, v);
             }
         }
     }
@@ -141,6 +143,7 @@ String VarDeclAST::emitLL(int*, String) const {
 }
 
 VarInitlAST::VarInitlAST(String name, sptr<AST> type, sptr<AST> expr, symbol::Variable* v, lexer::TokenStream tokens) {
+    kind             = KIND;
     this->name       = name;
     this->type       = type;
     this->expression = expr;
@@ -178,7 +181,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
                               {tokens[split + 1], tokens[tokens.size() - 1]},
                               "Expected an expression",
                               25);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             // if (!parser::isAtomic(type->getCstType()) ){
             //     parser::error("Unknown type", {tokens[0], tokens[tokens.size()-3]}, "A type of this name is unknown
@@ -190,7 +193,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
                               "A variable of this name is already defined in this scope",
                               25);
                 parser::note(sr->getLocal(name)[0]->tokens, "defined here:", 0);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             if (parser::isAtomic(name)) {
                 parser::error("Unsupported name",
@@ -198,7 +201,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
                               String("The name ") + name +
                                   " refers to a scope or type and cannot be used as a variable name",
                               25);
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
             if (!parser::is_snake_case(name) && !(m & parser::Modifier::CONST)) {
                 parser::warn("Wrong casing", {tokens[split - 1]}, "Variable name should be snake_case", 16);
@@ -213,7 +216,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
                         {tokens[split - 1]},
                         "This variable was declared as 'const' (unchangeable) and 'mut' (changeable) at the same time.",
                         0);
-                    return share<AST>(new AST);
+                    return parser::make<AST>();
                 }
                 if (m & parser::Modifier::STATIC) {
                     parser::warn("Variable declared as constant and static",
@@ -223,7 +226,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
                 }
             }
             expr->forceType(type->getCstType());
-            auto v = new symbol::Variable(name, type->getCstType(), tokens2.tokens, sr);
+            auto v = new symbol::Variable(name, type->getCstType(), tokens2, sr);
 
             if (m & parser::Modifier::CONST) {
                 if (!expr->is_const) {
@@ -256,7 +259,7 @@ sptr<AST> VarInitlAST::parse(PARSER_FN_PARAM) {
             if (parser::isAtomic(type->getCstType())) { v->isFree = true; }
             v->used = symbol::Variable::PROVIDED;
 
-            return share<AST>(new VarInitlAST(name, type, expr, v, tokens));
+            return parser::make<VarInitlAST>(name, type, expr, v, tokens);
         }
     }
     return nullptr;
@@ -270,6 +273,7 @@ String VarInitlAST::emitLL(int* locc, String) const {
 }
 
 VarAccesAST::VarAccesAST(String name, symbol::Variable* sr, lexer::TokenStream tokens) {
+    kind           = KIND;
     this->name     = name;
     this->var      = sr;
     this->tokens   = tokens;
@@ -287,15 +291,16 @@ sptr<AST> VarAccesAST::parse(PARSER_FN_PARAM) {
     String name = parse_name(tokens);
     DEBUG(5, "\tname: "s + name)
     if (name == "") { return nullptr; }
-    if (name == "null") { return share<AST>(new AST); }
+    if (name == "null") { return parser::make<AST>(); }
     if ((*sr)[name].size() == 0) {
         parser::error("Unknown variable", tokens, "A variable of this name was not found in this scope", 20);
         return ERR;
     }
 
     symbol::Reference* p = (*sr)[name].at(0);
-    if (p == dynamic_cast<symbol::Variable*>(p)) {
-        symbol::Variable::Status& u = ((symbol::Variable*) p)->used;
+    if (isa<symbol::Variable>(p)) {
+        std::lock_guard<std::mutex> lock(symbol::Variable::status_lock);
+        symbol::Variable::Status&   u = ((symbol::Variable*) p)->used;
         if (u == symbol::Variable::UNINITIALIZED) {
             parser::error(
                 "Variable uninitilialized",
@@ -304,7 +309,7 @@ sptr<AST> VarAccesAST::parse(PARSER_FN_PARAM) {
                     "\e[0m' is uninitilialized at this point.\nMake sure the variable holds a value to resolve.",
                 0);
             parser::note(p->tokens, "declared here", 0);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         } else if (u == symbol::Variable::CONSUMED && !((symbol::Variable*) p)->isFree) {
             parser::error("Type linearity violated",
                           tokens,
@@ -313,12 +318,11 @@ sptr<AST> VarAccesAST::parse(PARSER_FN_PARAM) {
                           0,
                           "");
             parser::note(p->last, "last consumed here", 0);
-            return share<AST>(new AST);
+            return parser::make<AST>();
         }
-        u       = symbol::Variable::CONSUMED;
-        p->last = tokens.tokens;
+        ((symbol::Variable*) p)->setStatus(symbol::Variable::CONSUMED, tokens);
     }
-    return share<AST>(new VarAccesAST(name, (symbol::Variable*) p, tokens));
+    return parser::make<VarAccesAST>(name, (symbol::Variable*) p, tokens);
 }
 
 void VarAccesAST::forceType(String type) {
@@ -339,6 +343,7 @@ String VarAccesAST::emitLL(int* locc, String inp) const {
 }
 
 VarSetAST::VarSetAST(String name, symbol::Variable* sr, sptr<AST> expr, lexer::TokenStream tokens) {
+    kind         = KIND;
     this->name   = name;
     this->var    = sr;
     this->expr   = expr;
@@ -356,7 +361,7 @@ sptr<AST> VarSetAST::parse(PARSER_FN_PARAM) {
     lexer::TokenStream::Match split = tokens.rsplitStack({lexer::Token::Type::SET});
     if (split.found() && (uint64) split == 0) {
         parser::error("Expected Expression", {tokens[tokens.size() - 1]}, "Expected an expression after '='", 31);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
     if (!split.found()) { return nullptr; }
     auto varname = split.before();
@@ -369,34 +374,35 @@ sptr<AST> VarSetAST::parse(PARSER_FN_PARAM) {
     sptr<AST> expr = math::parse(split.after(), local, sr);
     if (expr == nullptr) {
         parser::error("Expected Expression", {tokens[tokens.size() - 1]}, "Expected a valid expression after '='", 31);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
 
     if ((*sr)[name].size() == 0) {
         parser::error("Unknown variable", tokens, "A variable of this name was not found in this scope", 20);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
 
     expr->forceType((*sr)[name][0]->getCstType());
     symbol::Reference* p = (*sr)[name].at(0);
-    if (p == dynamic_cast<symbol::Variable*>(p) && ((symbol::Variable*) p)->isConst) {
+    if (isa<symbol::Variable>(p) && ((symbol::Variable*) p)->isConst) {
         parser::error("Trying to set constant",
                       tokens,
                       "You are trying to set a variable which has a constant value.",
                       17);
         parser::note(p->tokens, "defined here:", 0);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
-    if (!(p == dynamic_cast<symbol::Variable*>(p) && ((symbol::Variable*) p)->isMutable)) {
+    if (!(isa<symbol::Variable>(p) && ((symbol::Variable*) p)->isMutable)) {
         parser::error("Trying to set immutable",
                       tokens,
                       "You are trying to set a variable which was declared as immutable.",
                       18);
         parser::note(p->tokens, "defined here:", 0);
-        return share<AST>(new AST);
+        return parser::make<AST>();
     }
-    if (p == dynamic_cast<symbol::Variable*>(p)) {
-        symbol::Variable::Status& u = ((symbol::Variable*) p)->used;
+    if (isa<symbol::Variable>(p)) {
+        std::lock_guard<std::mutex> lock(symbol::Variable::status_lock);
+        symbol::Variable::Status&   u = ((symbol::Variable*) p)->used;
         if (u == symbol::Variable::PROVIDED) {
             fsignal<void, String, lexer::TokenStream, String, uint32, String> warn_error = parser::error;
             if (((symbol::Variable*) p)->isFree) { warn_error = parser::warn; }
@@ -409,13 +415,12 @@ sptr<AST> VarSetAST::parse(PARSER_FN_PARAM) {
                        "");
             parser::note(p->last, "last provided here", 0);
             if (warn_error == (fsignal<void, String, lexer::TokenStream, String, uint32, String>) parser::error) {
-                return share<AST>(new AST);
+                return parser::make<AST>();
             }
         }
-        u       = symbol::Variable::PROVIDED;
-        p->last = tokens.tokens;
+        ((symbol::Variable*) p)->setStatus(symbol::Variable::PROVIDED, tokens);
     }
-    return share<AST>(new VarSetAST(name, (symbol::Variable*) p, expr, tokens));
+    return parser::make<VarSetAST>(name, (symbol::Variable*) p, expr, tokens);
 }
 
 void VarSetAST::forceType(String type) {
@@ -478,7 +483,7 @@ sptr<AST> DeleteAST::parse(PARSER_FN_PARAM){
                 vars.push_back(vaast->var);
             }
         }
-        return share<AST>(new DeleteAST(vars, tokens));
+        return parser::make<DeleteAST>(vars, tokens);
     }
     return nullptr;
 }
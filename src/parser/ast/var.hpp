@@ -17,6 +17,8 @@ class VarDeclAST : public AST {
         String _str() const;
 
     public:
+        CLASS_KIND(VAR_DECL)
+
         VarDeclAST(String name, sptr<AST> type, symbol::Variable* v);
 
         virtual bool isConst() const { return false; } // do constant folding or not
@@ -51,6 +53,8 @@ class VarInitlAST : public AST {
         String _str() const;
 
     public:
+        CLASS_KIND(VAR_INIT)
+
         VarInitlAST(String name, sptr<AST> type, sptr<AST> expr, symbol::Variable* v, lexer::TokenStream tokens);
 
         virtual bool isConst() { return false; } // do constant folding or not
@@ -82,6 +86,8 @@ class VarAccesAST : public AST {
         String _str() const;
 
     public:
+        CLASS_KIND(VAR_ACCESS)
+
         symbol::Variable* var  = nullptr;
         VarAccesAST(String name, symbol::Variable* sr, lexer::TokenStream tokens);
 
@@ -114,6 +120,8 @@ class VarSetAST : public ExpressionAST {
         String _str() const;
 
     public:
+        CLASS_KIND(VAR_SET)
+
         VarSetAST(String name, symbol::Variable* sr, sptr<AST> expr, lexer::TokenStream tokens);
 
         virtual bool isConst() { return false; } // do constant folding or not
@@ -148,7 +156,10 @@ class DeleteAST : public AST {
         };
 
     public:
+        CLASS_KIND(DELETE)
+
         DeleteAST(std::vector<symbol::Variable*> vars, lexer::TokenStream tokens) {
+            kind       = KIND;
             this->vars = vars;
             this->tokens = tokens;
         }
@@ -10,25 +10,88 @@
 #include "ast/ast.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
 
-uint64 parser::errc = 0;
-uint64 parser::warnc = 0;
-bool   parser::one_error = false;
-bool   muted             = false;
+std::atomic<uint64> parser::errc      = 0;
+std::atomic<uint64> parser::warnc     = 0;
+bool                parser::one_error = false;
+thread_local uint64 parser::holding   = 0;
 
-void parser::mute() {
-    muted = true;
+static thread_local String       held_text = ""; //> diagnostics held back while parser::holding is set
+static thread_local parser::Held held_now  = {}; //> their amount
+
+/**
+ * @brief show a diagnostic or hold it back
+ */
+static void emit(const std::ostringstream& s) {
+    if (parser::holding > 0) {
+        held_text     += s.str();
+        held_now.size  = held_text.size();
+    } else {
+        std::cerr << s.str() << std::flush;
+    }
 }
-void parser::unmute() {
-    muted = false;
+
+/**
+ * @brief count an error or a warning, or hold the count back with its diagnostic
+ */
+static void count(bool is_error) {
+    if (parser::holding > 0) {
+        (is_error ? held_now.errc : held_now.warnc)++;
+    } else {
+        (is_error ? parser::errc : parser::warnc)++;
+    }
+}
+
+parser::Held parser::held() {
+    return held_now;
+}
+
+void parser::dropHeld(Held to) {
+    held_text.resize(to.size);
+    held_now = to;
+}
+
+String parser::takeHeld() {
+    errc  += held_now.errc;
+    warnc += held_now.warnc;
+    held_now    = {};
+    String text = std::move(held_text);
+    held_text.clear();
+    return text;
+}
+
+parser::Held parser::releaseHeld(Held from, String& text) {
+    text = held_text.substr(from.size);
+    Held amount = {held_now.size - from.size, held_now.errc - from.errc, held_now.warnc - from.warnc};
+    dropHeld(from);
+    return amount;
+}
+
+void parser::replay(std::string_view text, Held amount) {
+    if (holding > 0) {
+        held_text      += text;
+        held_now.size   = held_text.size();
+        held_now.errc  += amount.errc;
+        held_now.warnc += amount.warnc;
+    } else {
+        std::cerr << text << std::flush;
+        errc  += amount.errc;
+        warnc += amount.warnc;
+    }
+}
+
+void parser::showHeld() {
+    std::cerr << takeHeld() << std::flush;
 }
 
 void parser::showError(String errstr, String errcol, String errcol_lite, String name, String msg, std::vector<lexer::Token> tokens, uint32 code, String appendix){
-    if (muted) return;
+    std::ostringstream err;
     if (tokens.size() == 0) {
-        std::cerr << "OH NO! " << errstr << " " << name << " could not be displayed:\n" << intab(msg) << "\n";
+        err << "OH NO! " << errstr << " " << name << " could not be displayed:\n" << intab(msg) << "\n";
+        emit(err);
         return;
     }
     String location;
@@ -40,69 +103,87 @@ void parser::showError(String errstr, String errcol, String errcol_lite, String
         location += " - " + std::to_string(tokens.at(tokens.size()-1).l) + ":" + std::to_string(tokens.at(tokens.size()-1).c + tokens.at(tokens.size()-1).value.size()-1);
     }
 
-    std::cerr << "\r" << errcol << errstr << ": " << name << "\e[0m @ \e[0m" << tokens[0].filename << "\e[1m" << location << "\e[0m" << (code == 0? ""s : " ["s + errstr[0] + std::to_string(code) + "]") << ":" << std::endl;
-    std::cerr << msg << std::endl;
-    std::cerr << "       | " << std::endl;
+    err << "\r" << errcol << errstr << ": " << name << "\e[0m @ \e[0m" << tokens[0].filename() << "\e[1m" << location << "\e[0m" << (code == 0? ""s : " ["s + errstr[0] + std::to_string(code) + "]") << ":" << std::endl;
+    err << msg << std::endl;
+    err << "       | " << std::endl;
     if (tokens.size() == 1){
-        std::cerr << " " << fillup(std::to_string(tokens[0].l), 5) << " | " << *(tokens[0].line_contents) << std::endl;
-        std::cerr << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", tokens[0].value.size(), '^') << "\e[0m" << std::endl;
+        err << " " << fillup(std::to_string(tokens[0].l), 5) << " | " << tokens[0].lineContents() << std::endl;
+        err << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", tokens[0].value.size(), '^') << "\e[0m" << std::endl;
     } else {
-        std::cerr << " " << fillup(std::to_string(tokens[0].l), 5) << " | " << (*(tokens[0].line_contents)) << std::endl;
+        err << " " << fillup(std::to_string(tokens[0].l), 5) << " | " << tokens[0].lineContents() << std::endl;
         if (tokens[0].l == tokens.at(tokens.size()-1).l){
-            std::cerr << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", tokens.at(tokens.size()-1).c-(tokens[0].c-1)+tokens.at(tokens.size()-1).value.size()-1, '^') << "\e[0m" << std::endl;
+            err << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", tokens.at(tokens.size()-1).c-(tokens[0].c-1)+tokens.at(tokens.size()-1).value.size()-1, '^') << "\e[0m" << std::endl;
         }
         else {
-            std::cerr << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", (*(tokens[0].line_contents)).size()-(tokens[0].c-1)-1, '^') << "\e[0m" << std::endl;
+            err << "       | " << errcol_lite << fillup("", tokens[0].c-1) << fillup("", tokens[0].lineContents().size()-(tokens[0].c-1)-1, '^') << "\e[0m" << std::endl;
             if (tokens.at(tokens.size()-1).l - tokens[0].l > 1)
-                std::cerr << "       | \t" << errcol_lite << "(" << std::to_string(tokens.at(tokens.size()-1).l - tokens[0].l - 1) << " line" << (tokens.at(tokens.size()-1).l - tokens[0].l - 1 == 1 ? "" : "s") << " hidden)\e[0m" << std::endl; 
+                err << "       | \t" << errcol_lite << "(" << std::to_string(tokens.at(tokens.size()-1).l - tokens[0].l - 1) << " line" << (tokens.at(tokens.size()-1).l - tokens[0].l - 1 == 1 ? "" : "s") << " hidden)\e[0m" << std::endl; 
 
-            std::cerr << " " << fillup(std::to_string(tokens.at(tokens.size()-1).l), 5) << " | " << *(tokens.at(tokens.size()-1).line_contents) << std::endl;
-            std::cerr << "       | " << errcol_lite  << fillup("", tokens.at(tokens.size()-1).c + tokens.at(tokens.size()-1).value.size()-1, '^') << "\e[0m" << std::endl;
+            err << " " << fillup(std::to_string(tokens.at(tokens.size()-1).l), 5) << " | " << tokens.at(tokens.size()-1).lineContents() << std::endl;
+            err << "       | " << errcol_lite  << fillup("", tokens.at(tokens.size()-1).c + tokens.at(tokens.size()-1).value.size()-1, '^') << "\e[0m" << std::endl;
         }
     }
     
-    std::cerr << appendix << std::endl;
+    err << appendix << std::endl;
+    emit(err);
 }
 
 void parser::error(String name, lexer::TokenStream tokens, String msg, uint32 code, String appendix){
-    showError("ERROR", "\e[1;31m", "\e[31m", name, msg, tokens.tokens, code, appendix);
-    errc++;
-    if (one_error){
+    showError("ERROR", "\e[1;31m", "\e[31m", name, msg, tokens.list(), code, appendix);
+    count(true);
+    if (one_error && holding == 0){
         std::exit(3);
     }
 }
 void parser::error(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
     showError("ERROR", "\e[1;31m", "\e[31m", name, msg, tokens, code, appendix);
-    errc++;
-    if (one_error){
+    count(true);
+    if (one_error && holding == 0){
         std::exit(3);
     }
 }
 void parser::warn(String name, lexer::TokenStream tokens, String msg, uint32 code, String appendix){
-    showError("WARNING", "\e[1;33m", "\e[33m", name, msg, tokens.tokens, code, appendix);
-    warnc++;
+    showError("WARNING", "\e[1;33m", "\e[33m", name, msg, tokens.list(), code, appendix);
+    count(false);
 }
 void parser::note(lexer::TokenStream tokens, String msg, uint32 code, String appendix){
-    showError("NOTE", "\e[1;36m", "\e[36m", "", msg, tokens.tokens, code, appendix);
+    showError("NOTE", "\e[1;36m", "\e[36m", "", msg, tokens.list(), code, appendix);
 }
 void parser::warn(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
     showError("WARNING", "\e[1;33m", "\e[33m", name, msg, tokens, code, appendix);
-    warnc++;
+    count(false);
 }
 void parser::note(std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix){
     showError("NOTE", "\e[1;36m", "\e[36m", "", msg, tokens, code, appendix);
 }
+void parser::error(String name, lexer::SourceRange range, String msg, uint32 code, String appendix){
+    showError("ERROR", "\e[1;31m", "\e[31m", name, msg, range.ends(), code, appendix);
+    count(true);
+    if (one_error && holding == 0){
+        std::exit(3);
+    }
+}
+void parser::warn(String name, lexer::SourceRange range, String msg, uint32 code, String appendix){
+    showError("WARNING", "\e[1;33m", "\e[33m", name, msg, range.ends(), code, appendix);
+    count(false);
+}
+void parser::note(lexer::SourceRange range, String msg, uint32 code, String appendix){
+    showError("NOTE", "\e[1;36m", "\e[36m", "", msg, range.ends(), code, appendix);
+}
 
 void parser::noteInsert(String msg, lexer::Token after, String insert, uint32 code, bool before, String appendix){
 
+    std::ostringstream err;
     String location;
     location = ":"s + std::to_string(after.l) + ":" + std::to_string(after.c); 
 
-    std::cerr << "\r" << "\e[1;36mNote" << ": " << "\e[0m @ \e[0m" << after.filename << "\e[1m" << location << "\e[0m" << (code == 0? ""s : " [N"s + std::to_string(code) + "]") << ":" << std::endl;
-    std::cerr << msg << std::endl;
-    std::cerr << "       | " << std::endl;
-    std::cerr << " " << fillup(std::to_string(after.l), 5) << " | " << (*(after.line_contents)).insert(after.c-1 + (before? 0 : after.value.size()), "\e[36m"s + insert + "\e[0m") << std::endl;
-    std::cerr << "       | " << std::endl;
-    std::cerr << appendix << std::endl;
+    err << "\r" << "\e[1;36mNote" << ": " << "\e[0m @ \e[0m" << after.filename() << "\e[1m" << location << "\e[0m" << (code == 0? ""s : " [N"s + std::to_string(code) + "]") << ":" << std::endl;
+    err << msg << std::endl;
+    err << "       | " << std::endl;
+    String line = String(after.lineContents());
+    err << " " << fillup(std::to_string(after.l), 5) << " | " << line.insert(after.c-1 + (before? 0 : after.value.size()), "\e[36m"s + insert + "\e[0m") << std::endl;
+    err << "       | " << std::endl;
+    err << appendix << std::endl;
+    emit(err);
 }
 
@@ -8,15 +8,59 @@
 
 #include "../snippets.h"
 #include "../lexer/token.hpp"
+#include <atomic>
+#include <string_view>
 #include <vector>
 
 namespace parser {
-    extern uint64 errc;
-    extern uint64 warnc;
-    extern bool   one_error;
+    extern std::atomic<uint64> errc;
+    extern std::atomic<uint64> warnc;
+    extern bool                one_error;
 
-    extern void mute();
-    extern void unmute();
+    extern thread_local uint64 holding; //> while set, this thread's diagnostics are held back instead of shown
+
+    /**
+     * @struct Held the amount of diagnostics held back on a thread
+     */
+    struct Held {
+            uint64 size  = 0; //> size of their text
+            uint64 errc  = 0; //> errors among them
+            uint64 warnc = 0; //> warnings among them
+    };
+
+    /**
+     * @brief get the amount of diagnostics held back on this thread. They are not counted in errc and warnc yet
+     */
+    extern Held held();
+
+    /**
+     * @brief drop the diagnostics held back on this thread after the amount to
+     */
+    extern void dropHeld(Held to);
+
+    /**
+     * @brief show and count all diagnostics held back on this thread
+     */
+    extern void showHeld();
+
+    /**
+     * @brief count all diagnostics held back on this thread, but return them instead of showing them
+     */
+    extern String takeHeld();
+
+    /**
+     * @brief remove the diagnostics held back on this thread after the amount from without counting them
+     *
+     * @param text is set to their text
+     * @return their amount. @see replay
+     */
+    extern Held releaseHeld(Held from, String& text);
+
+    /**
+     * @brief show or hold back diagnostics released on another thread (@see releaseHeld), as if they were
+     * issued on this one
+     */
+    extern void replay(std::string_view text, Held amount);
 
     extern void error(String name, lexer::TokenStream tokens, String msg, uint32 code, String appendix="");
     extern void warn (String name, lexer::TokenStream tokens, String msg, uint32 code, String appendix="");
@@ -24,6 +68,9 @@ namespace parser {
     extern void error(String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix="");
     extern void warn (String name, std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix="");
     extern void note (std::vector<lexer::Token> tokens, String msg, uint32 code, String appendix="");
+    extern void error(String name, lexer::SourceRange range, String msg, uint32 code, String appendix="");
+    extern void warn (String name, lexer::SourceRange range, String msg, uint32 code, String appendix="");
+    extern void note (lexer::SourceRange range, String msg, uint32 code, String appendix="");
     extern void noteInsert (String msg, lexer::Token after, String insert, uint32 code, bool before=false, String appendix="");
     extern void showError(String errstr, String errcol, String errcol_lite, String name, String msg, std::vector<lexer::Token> tokens, uint32 code, String appendix);
 }
\ No newline at end of file
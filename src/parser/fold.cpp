@@ -0,0 +1,396 @@
+//
+// FOLD.cpp
+//
+// implements the constant folding engine
+//
+
+#include "fold.hpp"
+
+#include "../lexer/token.hpp"
+#include "../snippets.h"
+#include "types.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using fold::Constant;
+using Op = lexer::Token::Type;
+
+/**
+ * @brief the kinds of values that are computed the same way. float16 is computed in float32 precision,
+ * as there is no portable half type
+ */
+enum Domain : uint8 { SIGNED, UNSIGNED, FLOAT32, FLOAT64, FLOAT80, BOOLEAN, DOMAIN_COUNT };
+
+// clang-format off
+/**
+ * @brief the binary operators that can be folded, the rows of BINARY
+ */
+enum Operator : uint8 {
+    ADD, SUB, MUL, DIV, MOD, POW,
+    AND, OR, XOR, LAND, LOR,
+    EQ, NEQ, LESS, GREATER, LEQ, GEQ,
+    OPERATOR_COUNT
+};
+// clang-format on
+
+typedef Constant (*Binary)(const Constant&, const Constant&);
+typedef Constant (*Unary)(const Constant&);
+
+/**
+ * @brief get the domain of a type or -1 if constants of it can not be folded
+ */
+static int8 domainOf(const types::Type& t) {
+    switch (t.cls) {
+        case types::Type::BOOL :
+            return BOOLEAN;
+        case types::Type::SINT :
+        case types::Type::UINT :
+            if (t.bits == 0 || t.bits > 64) { return -1; }
+            return t.cls == types::Type::SINT ? SIGNED : UNSIGNED;
+        case types::Type::FLOAT :
+            return t.bits <= 32 ? FLOAT32 : t.bits <= 64 ? FLOAT64 : FLOAT80;
+        default :
+            return -1;
+    }
+}
+
+/**
+ * @brief get the row of an operator in BINARY or -1 if it has none
+ */
+static int8 operatorOf(Op op) {
+    switch (op) {
+        case Op::ADD :     return ADD;
+        case Op::SUB :     return SUB;
+        case Op::MUL :     return MUL;
+        case Op::DIV :     return DIV;
+        case Op::MOD :     return MOD;
+        case Op::POW :     return POW;
+        case Op::AND :     return AND;
+        case Op::OR :      return OR;
+        case Op::XOR :     return XOR;
+        case Op::LAND :    return LAND;
+        case Op::LOR :     return LOR;
+        case Op::EQ :      return EQ;
+        case Op::NEQ :     return NEQ;
+        case Op::LESS :    return LESS;
+        case Op::GREATER : return GREATER;
+        case Op::LEQ :     return LEQ;
+        case Op::GEQ :     return GEQ;
+        default :          return -1;
+    }
+}
+
+/**
+ * @brief cut an integer to bits, sign-extending it if the type is signed
+ */
+static uint64 wrap(uint64 v, uint16 bits, bool sig) {
+    if (bits >= 64) { return v; }
+    uint64 mask = (uint64(1) << bits) - 1;
+    v           &= mask;
+    if (sig && (v >> (bits - 1)) & 1) { v |= ~mask; }
+    return v;
+}
+
+static Constant boolean(bool v) {
+    Constant r = {types::BOOL};
+    r.boolean  = v;
+    return r;
+}
+
+// integers are computed exactly in 128 bits and then wrapped to the width of their type
+
+template <bool SIG>
+static __int128 intLoad(const Constant& c) {
+    return SIG ? (__int128) (int64) c.integer : (__int128) c.integer;
+}
+
+/**
+ * @brief make a constant of like's type from an exact result
+ *
+ * @param overflow whether computing exact already overflowed
+ */
+template <bool SIG>
+static Constant intStore(const Constant& like, __int128 exact, bool overflow = false) {
+    Constant r = {like.type};
+    r.integer  = wrap((uint64) exact, types::get(like.type).bits, SIG);
+    r.overflow = overflow || intLoad<SIG>(r) != exact;
+    return r;
+}
+
+template <bool SIG>
+static Constant intAdd(const Constant& a, const Constant& b) {
+    return intStore<SIG>(a, intLoad<SIG>(a) + intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intSub(const Constant& a, const Constant& b) {
+    return intStore<SIG>(a, intLoad<SIG>(a) - intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intMul(const Constant& a, const Constant& b) {
+    __int128 r;
+    bool     overflow = __builtin_mul_overflow(intLoad<SIG>(a), intLoad<SIG>(b), &r);
+    return intStore<SIG>(a, r, overflow);
+}
+
+template <bool SIG>
+static Constant intDiv(const Constant& a, const Constant& b) {
+    if (b.integer == 0) { return {}; }
+    return intStore<SIG>(a, intLoad<SIG>(a) / intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intMod(const Constant& a, const Constant& b) {
+    if (b.integer == 0) { return {}; }
+    return intStore<SIG>(a, intLoad<SIG>(a) % intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intPow(const Constant& a, const Constant& b) {
+    __int128 base = intLoad<SIG>(a);
+    __int128 exp  = intLoad<SIG>(b);
+    if (exp < 0) {
+        // only 1 and -1 have powers that are no fractions
+        if (base == 0) { return {}; }
+        return intStore<SIG>(a, base == 1 || base == -1 ? (exp % 2 == 0 ? 1 : base) : 0);
+    }
+
+    Constant r        = intStore<SIG>(a, 1);
+    Constant square   = a;
+    bool     overflow = false;
+    for (uint64 e = (uint64) exp; e != 0; e >>= 1) {
+        if (e & 1) {
+            r        = intMul<SIG>(r, square);
+            overflow = overflow || r.overflow;
+        }
+        if (e >> 1) {
+            // the square is part of the result, so if it wraps the result does
+            square   = intMul<SIG>(square, square);
+            overflow = overflow || square.overflow;
+        }
+    }
+    r.overflow = overflow;
+    return r;
+}
+
+template <bool SIG>
+static Constant intAnd(const Constant& a, const Constant& b) {
+    return intStore<SIG>(a, intLoad<SIG>(a) & intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intOr(const Constant& a, const Constant& b) {
+    return intStore<SIG>(a, intLoad<SIG>(a) | intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intXor(const Constant& a, const Constant& b) {
+    return intStore<SIG>(a, intLoad<SIG>(a) ^ intLoad<SIG>(b));
+}
+
+template <bool SIG>
+static Constant intNeg(const Constant& a) {
+    // flipping bits never wraps around. ~ of an unsigned value only looks like it does, as it is computed in 128 bits
+    Constant r = intStore<SIG>(a, ~intLoad<SIG>(a));
+    r.overflow = false;
+    return r;
+}
+
+// floats are computed in the precision of their type
+
+template <typename F>
+static F fltLoad(const Constant& c) {
+    return (F) c.floating;
+}
+
+template <typename F>
+static Constant fltStore(const Constant& like, F v) {
+    Constant r = {like.type};
+    r.floating = v;
+    return r;
+}
+
+template <typename F>
+static Constant fltAdd(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, fltLoad<F>(a) + fltLoad<F>(b));
+}
+
+template <typename F>
+static Constant fltSub(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, fltLoad<F>(a) - fltLoad<F>(b));
+}
+
+template <typename F>
+static Constant fltMul(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, fltLoad<F>(a) * fltLoad<F>(b));
+}
+
+template <typename F>
+static Constant fltDiv(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, fltLoad<F>(a) / fltLoad<F>(b));
+}
+
+template <typename F>
+static Constant fltMod(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, (F) std::fmod(fltLoad<F>(a), fltLoad<F>(b)));
+}
+
+template <typename F>
+static Constant fltPow(const Constant& a, const Constant& b) {
+    return fltStore<F>(a, (F) std::pow(fltLoad<F>(a), fltLoad<F>(b)));
+}
+
+// bools
+
+static Constant boolAnd(const Constant& a, const Constant& b) {
+    return boolean(a.boolean && b.boolean);
+}
+
+static Constant boolOr(const Constant& a, const Constant& b) {
+    return boolean(a.boolean || b.boolean);
+}
+
+static Constant boolXor(const Constant& a, const Constant& b) {
+    return boolean(a.boolean != b.boolean);
+}
+
+static Constant boolNot(const Constant& a) {
+    return boolean(!a.boolean);
+}
+
+// comparisons
+
+template <Operator O, typename T>
+static Constant compare(T a, T b) {
+    switch (O) {
+        case EQ :      return boolean(a == b);
+        case NEQ :     return boolean(a != b);
+        case LESS :    return boolean(a < b);
+        case GREATER : return boolean(a > b);
+        case LEQ :     return boolean(a <= b);
+        default :      return boolean(a >= b);
+    }
+}
+
+template <Operator O, bool SIG>
+static Constant intCompare(const Constant& a, const Constant& b) {
+    return compare<O>(intLoad<SIG>(a), intLoad<SIG>(b));
+}
+
+template <Operator O, typename F>
+static Constant fltCompare(const Constant& a, const Constant& b) {
+    return compare<O>(fltLoad<F>(a), fltLoad<F>(b));
+}
+
+template <Operator O>
+static Constant boolCompare(const Constant& a, const Constant& b) {
+    return compare<O>(a.boolean, b.boolean);
+}
+
+// clang-format off
+// all numbers can be compared, bools only for (in)equality
+#define COMPARE(o, b) {intCompare<o, true>, intCompare<o, false>, fltCompare<o, float32>, fltCompare<o, float64>, fltCompare<o, float80>, b}
+
+static const Binary BINARY[OPERATOR_COUNT][DOMAIN_COUNT] = { //> the folding function of each operator and domain
+    //             SIGNED        UNSIGNED       FLOAT32          FLOAT64          FLOAT80          BOOLEAN
+    /* ADD  */    {intAdd<true>, intAdd<false>, fltAdd<float32>, fltAdd<float64>, fltAdd<float80>, nullptr},
+    /* SUB  */    {intSub<true>, intSub<false>, fltSub<float32>, fltSub<float64>, fltSub<float80>, nullptr},
+    /* MUL  */    {intMul<true>, intMul<false>, fltMul<float32>, fltMul<float64>, fltMul<float80>, nullptr},
+    /* DIV  */    {intDiv<true>, intDiv<false>, fltDiv<float32>, fltDiv<float64>, fltDiv<float80>, nullptr},
+    /* MOD  */    {intMod<true>, intMod<false>, fltMod<float32>, fltMod<float64>, fltMod<float80>, nullptr},
+    /* POW  */    {intPow<true>, intPow<false>, fltPow<float32>, fltPow<float64>, fltPow<float80>, nullptr},
+    /* AND  */    {intAnd<true>, intAnd<false>, nullptr,         nullptr,         nullptr,         boolAnd},
+    /* OR   */    {intOr<true>,  intOr<false>,  nullptr,         nullptr,         nullptr,         boolOr},
+    /* XOR  */    {intXor<true>, intXor<false>, nullptr,         nullptr,         nullptr,         boolXor},
+    /* LAND */    {nullptr,      nullptr,       nullptr,         nullptr,         nullptr,         boolAnd},
+    /* LOR  */    {nullptr,      nullptr,       nullptr,         nullptr,         nullptr,         boolOr},
+    /* EQ   */    COMPARE(EQ, boolCompare<EQ>),
+    /* NEQ  */    COMPARE(NEQ, boolCompare<NEQ>),
+    /* LESS */    COMPARE(LESS, nullptr),
+    /* GREATER */ COMPARE(GREATER, nullptr),
+    /* LEQ  */    COMPARE(LEQ, nullptr),
+    /* GEQ  */    COMPARE(GEQ, nullptr),
+};
+
+static const Unary NOT[DOMAIN_COUNT] = {nullptr,      nullptr,       nullptr, nullptr, nullptr, boolNot}; //> '!'
+static const Unary NEG[DOMAIN_COUNT] = {intNeg<true>, intNeg<false>, nullptr, nullptr, nullptr, nullptr};   //> '~'
+
+#undef COMPARE
+// clang-format on
+
+Constant fold::read(types::TypeId type, const String& value) {
+    if (type == types::NO_TYPE) { return {}; }
+    int8 d = domainOf(types::get(type));
+    if (d < 0 || value.empty()) { return {}; }
+
+    Constant c = {type};
+    if (d == BOOLEAN) {
+        if (value != "true" && value != "false") { return {}; }
+        c.boolean = value == "true";
+    } else if (d == SIGNED || d == UNSIGNED) {
+        // decimal or hex, like the lexer reads them. Digits beyond 64 bits wrap around
+        uint64 i    = value[0] == '-';
+        bool   hex  = value.compare(i, 2, "0x") == 0;
+        uint64 base = hex ? 16 : 10;
+        if (hex) { i += 2; }
+        if (i == value.size()) { return {}; }
+        uint64 v = 0;
+        for (; i < value.size(); i++) {
+            char   ch    = value[i];
+            uint64 digit = ch >= '0' && ch <= '9' ? ch - '0'
+                           : hex && ch >= 'a' && ch <= 'f' ? ch - 'a' + 10
+                           : hex && ch >= 'A' && ch <= 'F' ? ch - 'A' + 10
+                                                           : base;
+            if (digit >= base) { return {}; }
+            v = v * base + digit;
+        }
+        if (value[0] == '-') { v = -v; }
+        c.integer = wrap(v, types::get(type).bits, d == SIGNED);
+    } else {
+        char* end  = nullptr;
+        c.floating = std::strtold(value.c_str(), &end);
+        if (*end != '\0') { return {}; }
+        c.floating = d == FLOAT32 ? (float80) (float32) c.floating
+                   : d == FLOAT64 ? (float80) (float64) c.floating
+                                  : c.floating;
+    }
+    return c;
+}
+
+String fold::write(const Constant& c) {
+    switch (domainOf(types::get(c.type))) {
+        case BOOLEAN :
+            return c.boolean ? "true" : "false";
+        case SIGNED :
+            return std::to_string((int64) c.integer);
+        case UNSIGNED :
+            return std::to_string(c.integer);
+        default : {
+            // enough digits to read the same value back
+            uint16 bits   = types::get(c.type).bits;
+            int    digits = bits <= 32 ? 9 : bits <= 64 ? 17 : 21;
+            char   buf[64];
+            std::snprintf(buf, sizeof(buf), "%.*Lg", digits, c.floating);
+            return buf;
+        }
+    }
+}
+
+Constant fold::binary(Op op, const Constant& a, const Constant& b) {
+    if (!a.valid() || a.type != b.type) { return {}; }
+    int8 o = operatorOf(op);
+    int8 d = domainOf(types::get(a.type));
+    if (o < 0 || d < 0 || BINARY[o][d] == nullptr) { return {}; }
+    return BINARY[o][d](a, b);
+}
+
+Constant fold::unary(Op op, const Constant& a) {
+    if (!a.valid()) { return {}; }
+    int8 d = domainOf(types::get(a.type));
+    if (d < 0) { return {}; }
+    Unary fn = op == Op::NOT ? NOT[d] : op == Op::NEG ? NEG[d] : nullptr;
+    return fn == nullptr ? Constant{} : fn(a);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+//
+// FOLD.hpp
+//
+// layouts the constant folding engine
+//
+
+#include "../lexer/token.hpp"
+#include "../snippets.h"
+#include "types.hpp"
+
+/**
+ * @namespace fold computes operators on constants at compile time. Values are typed: integers keep the width of
+ * their type and wrap around exactly like the generated code would, floats are computed in the precision of their
+ * type and bools are bools. Each operator is looked up in a static table by operator and kind of type.
+ */
+namespace fold {
+    /**
+     * @struct Constant a compile-time value of a built-in type
+     */
+    struct Constant {
+            types::TypeId type     = types::NO_TYPE; //> the value's type. NO_TYPE if the value could not be read
+            uint64        integer  = 0;              //> ints: the value, masked (unsigned) or sign-extended (signed)
+            float80       floating = 0;              //> floats: the value, rounded to the type's precision
+            bool          boolean  = false;          //> bools: the value
+            bool          overflow = false;          //> the operator that made this value wrapped around
+
+            inline bool valid() const { return type != types::NO_TYPE; }
+    };
+
+    /**
+     * @brief read a constant from the value of an AST (@see AST::value)
+     *
+     * @param type the type of the value. Only fixed-size ints up to 64 bits, floats and bool can be read
+     *
+     * @return the constant or an invalid one if the type is not supported or value is no number of it
+     */
+    Constant read(types::TypeId type, const String& value);
+
+    /**
+     * @brief write a constant the way AST::value holds it. Integers are decimal, floats keep all of their digits
+     */
+    String write(const Constant& c);
+
+    /**
+     * @brief apply a binary operator to two constants of the same type
+     *
+     * @return the result or an invalid constant if the operator cannot be folded, e.g. a division by zero
+     */
+    Constant binary(lexer::Token::Type op, const Constant& a, const Constant& b);
+
+    /**
+     * @brief apply a unary operator (! or ~) to a constant
+     *
+     * @return the result or an invalid constant if the operator cannot be folded
+     */
+    Constant unary(lexer::Token::Type op, const Constant& a);
+} // namespace fold
@@ -5,119 +5,99 @@
 #include "ast/ast.hpp"
 #include "errors.hpp"
 #include "symboltable.hpp"
+#include "types.hpp"
 
 #include <cmath>
+#include <cstdlib>
 #include <regex>
+#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
-#define INT_OPS(type)                                             \
-    if (type1 == type) {                                          \
-        if (op == lexer::Token::Type::NOT) return "";             \
-        if (op == lexer::Token::Type::NEG) return type;           \
-        if (type2 == "bool") {                                    \
-            if (op == lexer::Token::Type::AS) return "bool";      \
-        }                                                         \
-        if (std::regex_match(type2, int_regex)) {                 \
-            if (op == lexer::Token::Type::AS) return type2;       \
-        }                                                         \
-        if (std::regex_match(type2, flt_regex)) {                 \
-            if (op == lexer::Token::Type::AS) return type2;       \
-        }                                                         \
-        if (type2 == "char") {                                    \
-            if (op == lexer::Token::Type::AS) return "char";      \
-        }                                                         \
-        if (type2 == type) {                                      \
-            if (op == lexer::Token::Type::AND) return type;       \
-            if (op == lexer::Token::Type::OR) return type;        \
-            if (op == lexer::Token::Type::XOR) return type;       \
-            if (op == lexer::Token::Type::ADD) return type;       \
-            if (op == lexer::Token::Type::SUB) return type;       \
-            if (op == lexer::Token::Type::MUL) return type;       \
-            if (op == lexer::Token::Type::DIV) return type;       \
-            if (op == lexer::Token::Type::MOD) return type;       \
-            if (op == lexer::Token::Type::POW) return type;       \
-            if (op == lexer::Token::Type::LESS) return "bool";    \
-            if (op == lexer::Token::Type::GREATER) return "bool"; \
-            if (op == lexer::Token::Type::GEQ) return "bool";     \
-            if (op == lexer::Token::Type::LEQ) return "bool";     \
-            if (op == lexer::Token::Type::EQ) return "bool";      \
-            if (op == lexer::Token::Type::NEQ) return "bool";     \
-        }                                                         \
+parser::Stats parser::stats = {};
+
+static thread_local parser::Checkpoint* innermost = nullptr; //> checkpoint opened last on this thread
+
+parser::Checkpoint::Checkpoint() {
+    held      = parser::held();
+    changes   = symbol::journal::size();
+    outer     = innermost;
+    innermost = this;
+    holding++;
+    symbol::journal::recording++;
+}
+
+parser::Checkpoint::~Checkpoint() {
+    if (open) { commit(); }
+}
+
+void parser::Checkpoint::close() {
+    open      = false;
+    innermost = outer;
+    holding--;
+    symbol::journal::recording--;
+    if (symbol::journal::recording > 0) { return; }
+    // outermost checkpoint: nothing can be rolled back anymore. Under an outer hold (e.g. a module's), its diagnostics
+    // stay held back for whoever holds them. Changes recorded before it was opened belong to checkpoints set aside by
+    // an Escape
+    symbol::journal::clear(changes);
+    if (holding == 0) {
+        showHeld();
+        if (one_error && parser::errc > 0) { std::exit(3); }
     }
+}
+
+void parser::Checkpoint::commit() {
+    close();
+}
+
+void parser::Checkpoint::rollback() {
+    dropHeld(held);
+    symbol::journal::undo(changes);
+    close();
+}
+
+parser::Escape::Escape() {
+    recording = symbol::journal::recording;
+    if (recording == 0) { return; }
+    Checkpoint* c = innermost;
+    for (uint64 i = 1; i < recording; i++) { c = c->outer; }
+    outermost = c->held;
+    amount    = releaseHeld(outermost, speculative);
+    holding  -= recording;
+    symbol::journal::recording = 0;
+}
 
-#define FLT_OPS(type)                                             \
-    if (type1 == type) {                                          \
-        if (type2 == "bool") {                                    \
-            if (op == lexer::Token::Type::AS) return "bool";      \
-        }                                                         \
-        if (std::regex_match(type2, int_regex)) {                 \
-            if (op == lexer::Token::Type::AS) return type2;       \
-        }                                                         \
-        if (std::regex_match(type2, flt_regex)) {                 \
-            if (op == lexer::Token::Type::AS) return type2;       \
-        }                                                         \
-        if (type2 == "char") {                                    \
-            if (op == lexer::Token::Type::AS) return "char";      \
-        }                                                         \
-        if (type2 == type) {                                      \
-            if (op == lexer::Token::Type::ADD) return type;       \
-            if (op == lexer::Token::Type::SUB) return type;       \
-            if (op == lexer::Token::Type::MUL) return type;       \
-            if (op == lexer::Token::Type::DIV) return type;       \
-            if (op == lexer::Token::Type::MOD) return type;       \
-            if (op == lexer::Token::Type::POW) return type;       \
-            if (op == lexer::Token::Type::LESS) return "bool";    \
-            if (op == lexer::Token::Type::GREATER) return "bool"; \
-            if (op == lexer::Token::Type::GEQ) return "bool";     \
-            if (op == lexer::Token::Type::LEQ) return "bool";     \
-            if (op == lexer::Token::Type::EQ) return "bool";      \
-            if (op == lexer::Token::Type::NEQ) return "bool";     \
-        }                                                         \
+parser::Escape::~Escape() {
+    if (recording == 0) { return; }
+    // diagnostics held back meanwhile go before the speculative ones, so the checkpoints' marks move past them
+    Held now   = held();
+    Held shift = {now.size - outermost.size, now.errc - outermost.errc, now.warnc - outermost.warnc};
+    holding   += recording;
+    symbol::journal::recording = recording;
+    replay(speculative, amount);
+    Checkpoint* c = innermost;
+    for (uint64 i = 0; i < recording; i++, c = c->outer) {
+        c->held.size  += shift.size;
+        c->held.errc  += shift.errc;
+        c->held.warnc += shift.warnc;
     }
+}
 
-String parser::hasOp(String type1, String type2, lexer::Token::Type op) {
-    if (type1 == "@unknown" || type2 == "@unknown") { return "@unknown"; }
-
-    if (type2 == type1 + '?' && op == lexer::Token::Type::AS) { return type2; }
-
-    std::regex int_regex("u?int(8|16|32|64|128)");
-    std::regex flt_regex("float(16|32|64|80)");
-    if (type1 == "bool") {
-        if (op == lexer::Token::Type::NOT) { return "bool"; }
-        if (op == lexer::Token::Type::NEG) { return ""; }
-        if (type2 == "bool") {
-            if (op == lexer::Token::Type::LAND) { return "bool"; }
-            if (op == lexer::Token::Type::LOR) { return "bool"; }
-            if (op == lexer::Token::Type::NEQ) { return "bool"; }
-            if (op == lexer::Token::Type::EQ) { return "bool"; }
-            if (op == lexer::Token::Type::AND) { return "bool"; }
-            if (op == lexer::Token::Type::OR) { return "bool"; }
-            if (op == lexer::Token::Type::XOR) { return "bool"; }
-        }
-        if (std::regex_match(type2, int_regex)) {
-            if (op == lexer::Token::Type::AS) { return type2; }
-        }
+void parser::countExpression(const lexer::TokenStream& tokens, const String& expected_type) {
+    stats.expressions++;
+    if (!stats.repeats || tokens.empty()) { return; }
+    // tokens are identified by their position, so copies of them made by getTS() count as the same
+    static thread_local std::set<std::tuple<lexer::FileId, uint64, uint64, uint64, String>> seen = {};
+    lexer::Token first = tokens[0];
+    if (!seen.emplace(first.file, first.offset, tokens[-1].offset, tokens.size(), expected_type).second) {
+        stats.repeated++;
     }
-    INT_OPS("@int");
-    INT_OPS("uint8");
-    INT_OPS("uint16");
-    INT_OPS("uint32");
-    INT_OPS("uint64");
-    INT_OPS("usize");
-
-    INT_OPS("int8");
-    INT_OPS("int16");
-    INT_OPS("int32");
-    INT_OPS("int64");
-    INT_OPS("ssize");
-
-    FLT_OPS("float16");
-    FLT_OPS("float32");
-    FLT_OPS("float64");
-    FLT_OPS("float80");
-
-    return "";
+}
+
+String parser::hasOp(const CstType& type1, const CstType& type2, lexer::Token::Type op) {
+    return types::get(types::result(types::intern(type1), types::intern(type2), op)).name;
 }
 
 String match_token_clamp(lexer::Token::Type t) {
@@ -135,12 +115,12 @@ String match_token_clamp(lexer::Token::Type t) {
     }
 }
 
-sptr<AST> parser::parseOneOf(lexer::TokenStream                tokens,
-                             std::vector<PARSER_FN_NO_DEFAULT> functions,
-                             int                               local,
-                             symbol::Namespace*                sr,
-                             String                            expected_type) {
-    for (auto fn : functions) {
+sptr<AST> parser::parseOneOf(lexer::TokenStream                       tokens,
+                             const std::vector<PARSER_FN_NO_DEFAULT>& functions,
+                             int                                      local,
+                             symbol::Namespace*                       sr,
+                             String                                   expected_type) {
+    for (const auto& fn : functions) {
         sptr<AST> r = fn(tokens, local, sr, expected_type);
         if (r != nullptr) {
             DEBUG(2, "parser::parseOneOf: "s + r->emitCST());
@@ -150,32 +130,8 @@ sptr<AST> parser::parseOneOf(lexer::TokenStream                tokens,
     return nullptr;
 }
 
-bool parser::typeEq(String a, String b) {
-    if (a == "@unknown" || b == "@unknown") {
-        return true; // @unknown should ONLY be used for temporarily unknown types
-    }
-    if (a == b) { return true; }
-    if (a == "@int") {
-        return (b == "int8" || b == "int16" || b == "int32" || b == "int64" || b == "int128" || b == "int256" ||
-                b == "int512" || b == "int1024" || b == "uint8" || b == "uint16" || b == "uint32" || b == "uint64" || a == "ssize" || b == "usize" || b == "@uint");
-    }
-    if (a == "@float") { return b == "float32" || b == "float64"; }
-    if (b == "@int") {
-        return (a == "int8" || a == "int16" || a == "int32" || a == "int64" || a == "int128" || a == "int256" ||
-                a == "int512" || a == "int1024" || a == "uint8" || a == "uint16" || a == "uint32" || a == "uint64" ||
-                a == "usize" || a == "ssize"|| a == "@uint");
-    }
-    if (a == "@uint") {
-        return b == "uint8" || b == "uint16" || b == "uint32" || b == "uint64" || b == "uint128" || b == "uint256" ||
-               b == "uint512" || b == "uint1024" || b == "@uint" || a == "usize";
-    }
-    if (b == "@uint") {
-        return a == "uint8" || a == "uint16" || a == "uint32" || a == "uint64" || a == "uint128" || a == "uint256" ||
-               a == "uint512" || a == "uint1024" || a == "@uint" || a == "usize";
-    }
-    if (b == "@float") { return a == "float32" || a == "float64"; }
-
-    return false;
+bool parser::typeEq(const CstType& a, const CstType& b) {
+    return types::eq(types::intern(a), types::intern(b));
 }
 
 bool parser::isAtomic(String type) {
@@ -226,30 +182,10 @@ bool parser::IS_UPPER_CASE(String text) {
     return std::regex_match(text.c_str(), m, rx);
 }
 
-LLType parser::LLType(CstType name, symbol::Reference* sr) {
-    if (name == "int8") { return "i8"; }
-    if (name == "int16") { return "i16"; }
-    if (name == "int32") { return "i32"; }
-    if (name == "int64") { return "i64"; }
-
-    if (name == "uint8") { return "i8"; }
-    if (name == "uint16") { return "i16"; }
-    if (name == "uint32") { return "i32"; }
-    if (name == "uint64") { return "i64"; }
-
-    if (name == "float16") { return "half"; }
-    if (name == "float32") { return "float"; }
-    if (name == "float64") { return "double"; }
-
-    if (name == "char") { return "i16"; }
-    if (name == "bool") { return "i1"; }
-
-    if (name[name.size() - 1] == '?') { return "{ "s + LLType(name.substr(0, name.size() - 1)) + " , i1 }"; }
-
-    if (sr != nullptr) {
-        if ((*sr)[name].size() > 0) { return (*sr)[name][0]->getLLType(); }
-    }
-
+LLType parser::LLType(const CstType& name, symbol::Reference* sr) {
+    const types::Type& t = types::get(types::intern(name));
+    if (t.ll_fixed || sr == nullptr) { return t.ll; }
+    if ((*sr)[name].size() > 0) { return (*sr)[name][0]->getLLType(); }
     return name;
 }
 
@@ -271,7 +207,7 @@ parser::Modifier parser::getModifier(lexer::TokenStream& tokens) {
     DEBUG(3, "parser::getModifier: "s + std::to_string(i) + "/" + std::to_string(tokens.size()));
 
     if (i == tokens.size()) {
-        tokens.tokens = {};
+        tokens = lexer::TokenStream({});
     } else if (tokens.size() > 0) {
         tokens = tokens.slice(i, 1, tokens.size());
     }
@@ -10,8 +10,10 @@
 #include "../lexer/token.hpp"
 #include "../snippets.h"
 #include "ast/ast.hpp"
+#include "errors.hpp"
 #include "symboltable.hpp"
 
+#include <atomic>
 #include <vector>
 
 /**
@@ -19,6 +21,82 @@
  */
 namespace parser {
 
+    /**
+     * @brief counters of the work the parser did. Shown with --stats
+     */
+    struct Stats {
+            bool                repeats     = false; //> whether to look for expressions parsed more than once
+            std::atomic<uint64> statements  = 0;     //> statements parsed in blocks
+            std::atomic<uint64> attempts    = 0;     //> statement parsers called for them
+            std::atomic<uint64> expressions = 0;     //> expressions parsed by math::parse
+            std::atomic<uint64> repeated    = 0;     //> expressions parsed again with the same tokens and expected type
+    };
+
+    extern Stats stats;
+
+    /**
+     * @class Checkpoint makes the parse done while it is open speculative. Diagnostics are held back and changes to
+     * the symbol table are recorded, so rollback() can discard the parse without a trace: the diagnostics and their
+     * counts are dropped and the changes undone. commit() keeps everything and shows the diagnostics once nothing
+     * holds them back anymore. Checkpoints nest and are committed when they go out of scope.
+     */
+    class Checkpoint final {
+            Held        held;        //> diagnostics held back when opened
+            uint64      changes;     //> number of changes recorded when opened
+            bool        open = true; //> whether it was neither committed nor rolled back yet
+            Checkpoint* outer;       //> checkpoint open on this thread when this one was opened
+
+            friend class Escape;
+
+            /**
+             * @brief close this checkpoint. The outermost one shows the diagnostics and forgets the changes
+             */
+            void close();
+
+        public:
+            Checkpoint();
+            ~Checkpoint();
+
+            Checkpoint(const Checkpoint&)            = delete;
+            Checkpoint& operator=(const Checkpoint&) = delete;
+
+            /**
+             * @brief keep everything done since this checkpoint was opened
+             */
+            void commit();
+
+            /**
+             * @brief undo everything done since this checkpoint was opened
+             */
+            void rollback();
+    };
+
+    /**
+     * @class Escape takes the parse done while it lives out of the checkpoints open on this thread: they are set
+     * aside, so its diagnostics are shown or held back as if none was open and its changes to the symbol table are
+     * not recorded. A rollback of those checkpoints keeps both. Used for parses that happen only once, whatever
+     * triggered them, like the body of a function parsed when it is first used.
+     */
+    class Escape final {
+            uint64 recording;   //> number of checkpoints set aside
+            Held   outermost;   //> diagnostics held back when the outermost of them was opened
+            String speculative; //> diagnostics held back by them
+            Held   amount;      //> their amount
+
+        public:
+            Escape();
+            ~Escape();
+
+            Escape(const Escape&)            = delete;
+            Escape& operator=(const Escape&) = delete;
+    };
+
+    /**
+     * @brief count an expression parse. If stats.repeats is set, it is also checked against the expressions parsed
+     * before, which costs a lookup
+     */
+    void countExpression(const lexer::TokenStream& tokens, const String& expected_type);
+
     /**
      * @brief split a vector of tokens until a certain token was found. uses index, block and paranthesisises as descent
      *
@@ -61,11 +139,11 @@ namespace parser {
      *
      * @return An AST Node or nullptr if no match was found
      */
-    extern sptr<AST> parseOneOf(lexer::TokenStream                tokens,
-                                std::vector<PARSER_FN_NO_DEFAULT> functions,
-                                int                               local,
-                                symbol::Namespace*                sr,
-                                String                            expected_type);
+    extern sptr<AST> parseOneOf(lexer::TokenStream                       tokens,
+                                const std::vector<PARSER_FN_NO_DEFAULT>& functions,
+                                int                                      local,
+                                symbol::Namespace*                       sr,
+                                String                                   expected_type);
 
     /**
      * @brief get a (new) subvector from another vector
@@ -77,8 +155,15 @@ namespace parser {
         return std::vector<T>(s, end);
     }
 
-    extern bool   typeEq(CstType a, CstType b);
-    extern String hasOp(CstType type1, CstType type2, lexer::Token::Type op);
+    /**
+     * @brief check if values of types a and b can be used for each other. @see types::eq
+     */
+    extern bool   typeEq(const CstType& a, const CstType& b);
+
+    /**
+     * @brief get the type an operator on values of type1 and type2 yields, "" if there is none. @see types::result
+     */
+    extern String hasOp(const CstType& type1, const CstType& type2, lexer::Token::Type op);
     extern bool   isAtomic(CstType type);
 
     /**
@@ -109,7 +194,10 @@ namespace parser {
      */
     extern Modifier getModifier(lexer::TokenStream& tokens);
 
-    extern LLType LLType(CstType, symbol::Reference* sr = nullptr);
+    /**
+     * @brief get the LLVM IR type of a type. Names without a fixed one are looked up in sr if given
+     */
+    extern LLType LLType(const CstType&, symbol::Reference* sr = nullptr);
 
     /**
      * @brief check if an identifier is allowed as a name
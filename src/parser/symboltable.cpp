@@ -9,6 +9,52 @@
 #include <string>
 #include <vector>
 
+/**
+ * @brief a change to the symbol table. Either a variable's status was changed or a symbol was added
+ */
+struct Change {
+        symbol::Variable*         var  = nullptr;                         //> variable that was changed
+        symbol::Variable::Status  used = symbol::Variable::UNINITIALIZED; //> its status before
+        lexer::SourceRange        last = {};                              //> where it was changed before
+        symbol::Namespace*        in   = nullptr;                         //> namespace a symbol was added to
+        String                    loc  = "";                              //> name of the symbol added
+};
+
+thread_local uint64                     symbol::journal::recording = 0;
+static thread_local std::vector<Change> changes                    = {}; //> recorded while journal::recording is set
+
+uint64 symbol::journal::size() {
+    return changes.size();
+}
+
+void symbol::journal::undo(uint64 to) {
+    while (changes.size() > to) {
+        Change& c = changes.back();
+        if (c.var != nullptr) {
+            c.var->used = c.used;
+            c.var->last = c.last;
+        } else {
+            std::vector<Reference*>& at = c.in->contents.at(c.loc);
+            delete at.back();
+            at.pop_back();
+            if (at.empty()) { c.in->contents.erase(c.loc); }
+        }
+        changes.pop_back();
+    }
+}
+
+void symbol::journal::clear(uint64 to) {
+    changes.resize(to);
+}
+
+std::mutex symbol::Variable::status_lock;
+
+void symbol::Variable::setStatus(Status status, lexer::SourceRange at) {
+    if (journal::recording > 0) { changes.push_back({this, used, last}); }
+    used = status;
+    last = at;
+}
+
 void symbol::Namespace::add(String loc, symbol::Reference* sr) {
     size pos   = loc.find("::");
     sr->parent = this;
@@ -17,6 +63,7 @@ void symbol::Namespace::add(String loc, symbol::Reference* sr) {
     } else {
         if (contents.count(loc) == 0) { contents[loc] = {}; }
         contents.at(loc).push_back(sr);
+        if (journal::recording > 0) { changes.push_back({nullptr, Variable::UNINITIALIZED, {}, this, loc}); }
     }
 
     // debug(str(sr) + " added at "s + loc.substr(0,pos), 3);
@@ -59,7 +106,7 @@ std::vector<symbol::Reference*> symbol::Namespace::getLocal(String subloc) {
         String tail = subloc.substr(pos + 2, subloc.size() - pos - 2);
         if (contents.count(head) == 0) {
             result = {};
-        } else if ((Namespace*) contents[head][0] != dynamic_cast<Namespace*>(contents[head][0])) {
+        } else if (!isa<Namespace>(contents[head][0])) {
             result = {};
         } else {
             result = (*((Namespace*) contents[head][0]))[tail];
@@ -72,10 +119,9 @@ std::vector<symbol::Reference*> symbol::Namespace::getLocal(String subloc) {
 symbol::Namespace::LinearitySnapshot symbol::Namespace::snapshot() const {
     LinearitySnapshot l({});
     for (auto s : contents) {
-        auto a   = dynamic_cast<symbol::Variable*>(s.second[0]);
-        auto var = (symbol::Variable*) (s.second[0]);
-        DEBUG(7, "snapshot: var? "s + std::to_string(a == var));
-        if (a == var && !var->isFree) {
+        auto var = dyn_cast<symbol::Variable>(s.second[0]);
+        DEBUG(7, "snapshot: var? "s + std::to_string(var != nullptr));
+        if (var != nullptr && !var->isFree) {
             DEBUG(7, "snapshot: ["s + var->getVarName() + "] used: "s + std::to_string(var->used));
             l.data[var] = var->used;
         }
@@ -112,7 +158,8 @@ void symbol::Namespace::LinearitySnapshot::traceback(LinearitySnapshot ls) const
 }
 
 symbol::Function::Function(symbol::Reference* parent, String name, lexer::TokenStream tokens, CstType type) {
-    this->tokens = tokens.tokens;
+    kind         = FUNCTION;
+    this->tokens = tokens;
     this->loc    = name;
     this->parent = parent;
     this->type   = type;
@@ -5,6 +5,7 @@
 #include "ast/ast.hpp"
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,9 +23,28 @@ namespace symbol {
             virtual String _str() const { return "symbol::Reference"s; }
 
         public:
-            std::vector<lexer::Token> tokens = {};
-            std::vector<lexer::Token> last   = {};
-            Reference*                parent = nullptr;
+            /**
+             * @enum Kind of all reference classes. Subclasses of a class follow it, so a class and its subclasses
+             * are a range of kinds (@see isa)
+             */
+            enum Kind : uint8 {
+                VARIABLE,
+                ENUM_ENTRY,
+                NAMESPACE,
+                SUB_BLOCK,
+                FUNCTION,
+                STRUCT,
+                MODULE,
+                ENUM,
+                ENUM_GROUP,
+            };
+
+            CLASS_KINDS(VARIABLE, ENUM_GROUP)
+
+            Kind               kind   = VARIABLE; //> class of this reference, set by the constructors
+            lexer::SourceRange tokens = {};       //> where this is declared
+            lexer::SourceRange last   = {};       //> where this was last changed
+            Reference*         parent = nullptr;
 
             virtual ~Reference();
 
@@ -77,7 +97,12 @@ namespace symbol {
             bool   isFree    = false;
             String const_value;
 
-            Variable(String name, LLType type, std::vector<lexer::Token> tokens, symbol::Reference* parent) {
+            static std::mutex status_lock; //> guards used of variables shared by modules that are parsed in parallel
+
+            CLASS_KIND(VARIABLE)
+
+            Variable(String name, LLType type, lexer::SourceRange tokens, symbol::Reference* parent) {
+                kind         = VARIABLE;
                 loc          = name;
                 this->tokens = tokens;
                 last         = tokens;
@@ -92,6 +117,11 @@ namespace symbol {
 
             String getVarName() const { return name; }
 
+            /**
+             * @brief change this variable's linearity status and where it was changed. Recorded in the journal
+             */
+            void setStatus(Status status, lexer::SourceRange at);
+
             virtual LLType getLLType() { return "void"s; }
 
             virtual void add(String, Reference*) {}
@@ -116,9 +146,15 @@ namespace symbol {
             MultiMap<String, Reference*> contents     = {};
             std::vector<String>          unknown_vars = {};
             virtual void                 add(String loc, Reference* sr);
-            Namespace() = default;
 
-            Namespace(String loc) { this->loc = loc; };
+            CLASS_KINDS(NAMESPACE, ENUM_GROUP)
+
+            Namespace() { kind = NAMESPACE; }
+
+            Namespace(String loc) {
+                kind      = NAMESPACE;
+                this->loc = loc;
+            };
 
             virtual ~Namespace();
 
@@ -173,7 +209,10 @@ namespace symbol {
     class SubBlock : public Namespace {
             String name;
         public:
+            CLASS_KIND(SUB_BLOCK)
+
             SubBlock(symbol::Namespace* copyFrom) {
+                kind = SUB_BLOCK;
                 ALLOWS_VAR_DECL    = copyFrom->ALLOWS_VAR_DECL;
                 ALLOWS_VAR_SET     = copyFrom->ALLOWS_VAR_SET;
                 ALLOWS_VISIBILITY  = copyFrom->ALLOWS_VISIBILITY;
@@ -214,6 +253,11 @@ namespace symbol {
             std::map<String, std::pair<CstType, sptr<AST>>> name_parameters;
             bool                 is_method = false;
 
+            CLASS_KIND(FUNCTION)
+
+            sptr<AST>  definition = nullptr; //> definition whose body is not parsed yet (@see FuncDefAST::parseLazily)
+            std::mutex definition_lock;      //> guards definition, which is taken by the first thread using the function
+
             Function(symbol::Reference* parent, String name, lexer::TokenStream tokens, CstType type);
 
             LLType getLLType() { return "void"s; }
@@ -222,7 +266,7 @@ namespace symbol {
 
             CstType getCstType();
             CstType getReturnType() const { return type; }
-            virtual ~Function() { Namespace::~Namespace(); };
+            virtual ~Function() = default;
 
             virtual size sizeBytes() { return 8; }
 
@@ -252,9 +296,12 @@ namespace symbol {
 
             virtual ~Struct() {}
 
-            Struct(const String& name, std::vector<lexer::Token> tokens) {
+            CLASS_KIND(STRUCT)
+
+            Struct(const String& name, lexer::SourceRange tokens) {
+                kind         = STRUCT;
                 loc          = name;
-                this->tokens = std::move(tokens);
+                this->tokens = tokens;
 
                 ALLOWS_INIT_CONST = true;
                 ALLOWS_VAR_DECL   = true;
@@ -275,7 +322,12 @@ namespace symbol {
     class EnumEntry : public Reference {
             virtual ~EnumEntry() = default;
 
-            EnumEntry(String name) { loc = name; }
+            CLASS_KIND(ENUM_ENTRY)
+
+            EnumEntry(String name) {
+                kind = ENUM_ENTRY;
+                loc  = name;
+            }
     };
 
     class Enum : public Namespace {
@@ -303,13 +355,44 @@ namespace symbol {
                 ALLOWS_SUBCLASSES = false;
             }
 
-            Enum(String name) { loc = name; }
+            CLASS_KINDS(ENUM, ENUM_GROUP)
+
+            Enum(String name) {
+                kind = ENUM;
+                loc  = name;
+            }
     };
 
     class EnumGroup : public Enum {
             /**
              * Reference that holds data for an Enumeration type
              */
+        public:
+            CLASS_KIND(ENUM_GROUP)
     };
+
+    /**
+     * @brief the journal of changes to the symbol table (variables' linearity status and added symbols), so they
+     * can be undone. Each thread has its own, changes are only recorded while recording is set.
+     * @see parser::Checkpoint
+     */
+    namespace journal {
+        extern thread_local uint64 recording; //> number of checkpoints open on this thread
+
+        /**
+         * @brief get the number of changes recorded
+         */
+        uint64 size();
+
+        /**
+         * @brief undo all changes recorded after the first to. Added symbols are removed and deleted
+         */
+        void undo(uint64 to);
+
+        /**
+         * @brief forget the changes recorded after the first to, they can not be undone anymore
+         */
+        void clear(uint64 to);
+    } // namespace journal
 } // namespace symbol
 
@@ -0,0 +1,253 @@
+//
+// TYPES.cpp
+//
+// implements the interned type table
+//
+
+#include "types.hpp"
+
+#include "../lexer/token.hpp"
+#include "../snippets.h"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+using types::Type;
+using types::TypeId;
+using Op = lexer::Token::Type;
+
+/**
+ * @struct BuiltIn a type the compiler knows
+ */
+struct BuiltIn {
+        const char* name;
+        Type::Class cls;
+        uint16      bits;
+        TypeId      super;
+};
+
+// clang-format off
+static const BuiltIn BUILT_INS[] = { //> in the order of their ids (@see types::UNKNOWN)
+    {"@unknown", Type::SPECIAL,   0,   types::NO_TYPE},
+    {"",         Type::SPECIAL,   0,   types::NO_TYPE},
+    {"@int",     Type::ANY_INT,   0,   types::NO_TYPE},
+    {"@uint",    Type::ANY_UINT,  0,   types::ANY_INT},
+    {"@float",   Type::ANY_FLOAT, 0,   types::NO_TYPE},
+    {"bool",     Type::BOOL,      1,   types::NO_TYPE},
+    {"char",     Type::CHAR,      16,  types::NO_TYPE},
+
+    {"int8",     Type::SINT,      8,   types::ANY_INT},
+    {"int16",    Type::SINT,      16,  types::ANY_INT},
+    {"int32",    Type::SINT,      32,  types::ANY_INT},
+    {"int64",    Type::SINT,      64,  types::ANY_INT},
+    {"int128",   Type::SINT,      128, types::ANY_INT},
+    {"ssize",    Type::SINT,      0,   types::ANY_INT},
+
+    {"uint8",    Type::UINT,      8,   types::ANY_UINT},
+    {"uint16",   Type::UINT,      16,  types::ANY_UINT},
+    {"uint32",   Type::UINT,      32,  types::ANY_UINT},
+    {"uint64",   Type::UINT,      64,  types::ANY_UINT},
+    {"uint128",  Type::UINT,      128, types::ANY_UINT},
+    {"usize",    Type::UINT,      0,   types::ANY_UINT},
+
+    {"float16",  Type::FLOAT,     16,  types::ANY_FLOAT},
+    {"float32",  Type::FLOAT,     32,  types::ANY_FLOAT},
+    {"float64",  Type::FLOAT,     64,  types::ANY_FLOAT},
+    {"float80",  Type::FLOAT,     80,  types::ANY_FLOAT},
+};
+
+static const std::pair<const char*, const char*> BUILT_IN_LL[] = { //> LLVM IR types of the built-in types
+    {"int8",    "i8"},   {"int16",   "i16"},   {"int32",   "i32"},    {"int64",   "i64"},
+    {"uint8",   "i8"},   {"uint16",  "i16"},   {"uint32",  "i32"},    {"uint64",  "i64"},
+    {"float16", "half"}, {"float32", "float"}, {"float64", "double"},
+    {"char",    "i16"},  {"bool",    "i1"},
+};
+
+static const Op OPS[] = { //> the operators built-in types have
+    Op::NOT, Op::NEG, Op::AS,
+    Op::AND, Op::OR, Op::XOR, Op::LAND, Op::LOR,
+    Op::ADD, Op::SUB, Op::MUL, Op::DIV, Op::MOD, Op::POW,
+    Op::LESS, Op::GREATER, Op::GEQ, Op::LEQ, Op::EQ, Op::NEQ,
+};
+// clang-format on
+
+static constexpr uint64 BUILT_IN_COUNT = sizeof(BUILT_INS) / sizeof(BUILT_INS[0]);
+static constexpr uint64 OP_COUNT       = sizeof(OPS) / sizeof(OPS[0]);
+static constexpr uint64 CHUNK_SIZE     = 1024; //> types per chunk of the table
+static constexpr uint64 MAX_CHUNKS     = 4096; //> chunks of the table. Chunks never move, so lookups need no lock
+
+/**
+ * @brief get the LLVM IR type of a type name without looking at a symbol table
+ *
+ * @param fixed is set if the name has a fixed LLVM IR type. Otherwise the name is returned
+ */
+static LLType ownLL(std::string_view name, bool& fixed) {
+    fixed = true;
+    for (const auto& b : BUILT_IN_LL) {
+        if (name == b.first) { return b.second; }
+    }
+    if (!name.empty() && name.back() == '?') {
+        bool inner;
+        return "{ "s + ownLL(name.substr(0, name.size() - 1), inner) + " , i1 }";
+    }
+    fixed = false;
+    return String(name);
+}
+
+/**
+ * @brief get the type the built-in operator op yields on a and b
+ */
+static TypeId builtInOp(TypeId a, const Type& ta, TypeId b, const Type& tb, Op op) {
+    if (a == types::BOOL) {
+        if (op == Op::NOT) { return types::BOOL; }
+        if (op == Op::AS) { return tb.isSizedInt() ? b : types::NONE; }
+        if (b != types::BOOL) { return types::NONE; }
+        switch (op) {
+            case Op::LAND : case Op::LOR : case Op::EQ : case Op::NEQ : case Op::AND : case Op::OR : case Op::XOR :
+                return types::BOOL;
+            default :
+                return types::NONE;
+        }
+    }
+
+    bool is_int = ta.cls == Type::ANY_INT || ((ta.cls == Type::SINT || ta.cls == Type::UINT) && ta.bits <= 64);
+    if (!is_int && !ta.isFloat()) { return types::NONE; }
+    if (is_int && op == Op::NOT) { return types::NONE; }
+    if (is_int && op == Op::NEG) { return a; }
+    if (op == Op::AS) {
+        return b == types::BOOL || b == types::CHAR || tb.isSizedInt() || tb.isFloat() ? b : types::NONE;
+    }
+    if (b != a) { return types::NONE; }
+    switch (op) {
+        case Op::AND : case Op::OR : case Op::XOR :
+            return is_int ? a : types::NONE;
+        case Op::ADD : case Op::SUB : case Op::MUL : case Op::DIV : case Op::MOD : case Op::POW :
+            return a;
+        case Op::LESS : case Op::GREATER : case Op::GEQ : case Op::LEQ : case Op::EQ : case Op::NEQ :
+            return types::BOOL;
+        default :
+            return types::NONE;
+    }
+}
+
+/**
+ * @class Registry holds all interned types and the operator table of the built-in ones
+ */
+class Registry final {
+        std::unordered_map<std::string_view, TypeId> ids   = {}; //> ids by name. Keys are views of the names in chunks
+        uint64                                       count = 0;  //> number of types interned
+
+    public:
+        std::unique_ptr<Type[]> chunks[MAX_CHUNKS];                     //> the types, CHUNK_SIZE at a time
+        std::shared_mutex       lock;                                   //> guards ids, count and adding chunks
+        int8                    op_index[lexer::Token::X + 1];          //> index of each operator in OPS or -1
+        TypeId ops[BUILT_IN_COUNT + 1][BUILT_IN_COUNT + 1][OP_COUNT];   //> built-in operators. The last row and
+                                                                        //> column stand for all other types
+
+        Registry() {
+            for (const BuiltIn& b : BUILT_INS) {
+                TypeId id = add(b.name);
+                Type&  t  = at(id);
+                t.cls     = b.cls;
+                t.bits    = b.bits;
+                t.super   = b.super;
+            }
+
+            for (int8& i : op_index) { i = -1; }
+            for (uint64 o = 0; o < OP_COUNT; o++) { op_index[OPS[o]] = o; }
+
+            Type other = {};
+            for (uint64 a = 0; a <= BUILT_IN_COUNT; a++) {
+                for (uint64 b = 0; b <= BUILT_IN_COUNT; b++) {
+                    for (uint64 o = 0; o < OP_COUNT; o++) {
+                        ops[a][b][o] = a == BUILT_IN_COUNT ? types::NONE
+                                                           : builtInOp(a,
+                                                                       at(a),
+                                                                       b < BUILT_IN_COUNT ? b : types::NO_TYPE,
+                                                                       b < BUILT_IN_COUNT ? at(b) : other,
+                                                                       OPS[o]);
+                    }
+                }
+            }
+        }
+
+        inline Type& at(TypeId id) { return chunks[id / CHUNK_SIZE][id % CHUNK_SIZE]; }
+
+        /**
+         * @brief get the id of a name, adding it if needed. The lock has to be held exclusively
+         */
+        TypeId add(std::string_view name) {
+            auto it = ids.find(name);
+            if (it != ids.end()) { return it->second; }
+
+            TypeId optional = !name.empty() && name.back() == '?' ? add(name.substr(0, name.size() - 1)) : types::NO_TYPE;
+            if (count == CHUNK_SIZE * MAX_CHUNKS) { throw std::length_error("too many types"); }
+            if (count % CHUNK_SIZE == 0) { chunks[count / CHUNK_SIZE] = std::make_unique<Type[]>(CHUNK_SIZE); }
+
+            TypeId id  = count++;
+            Type&  t   = at(id);
+            t.name     = String(name);
+            t.ll       = ownLL(name, t.ll_fixed);
+            t.optional = optional;
+            ids.emplace(t.name, id);
+            return id;
+        }
+
+        /**
+         * @brief get the id of a name if it was interned already. The lock has to be held
+         */
+        TypeId find(std::string_view name) const {
+            auto it = ids.find(name);
+            return it == ids.end() ? types::NO_TYPE : it->second;
+        }
+};
+
+/**
+ * @brief get the registry. Created on first use, so the table is ready before any static initializer needs it
+ */
+static Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+TypeId types::intern(std::string_view name) {
+    Registry& r = registry();
+    {
+        std::shared_lock<std::shared_mutex> l(r.lock);
+        TypeId                              id = r.find(name);
+        if (id != NO_TYPE) { return id; }
+    }
+    std::unique_lock<std::shared_mutex> l(r.lock);
+    return r.add(name);
+}
+
+const Type& types::get(TypeId id) {
+    return registry().at(id);
+}
+
+TypeId types::result(TypeId a, TypeId b, lexer::Token::Type op) {
+    if (a == UNKNOWN || b == UNKNOWN) { return UNKNOWN; }
+    Registry& r = registry();
+    if (op == Op::AS && r.at(b).optional == a) { return b; }
+    int8 o = r.op_index[op];
+    if (o < 0) { return NONE; }
+    return r.ops[std::min<uint64>(a, BUILT_IN_COUNT)][std::min<uint64>(b, BUILT_IN_COUNT)][o];
+}
+
+/**
+ * @brief check if a is a subtype of b
+ */
+static bool below(TypeId a, TypeId b) {
+    for (TypeId t = types::get(a).super; t != types::NO_TYPE; t = types::get(t).super) {
+        if (t == b) { return true; }
+    }
+    return false;
+}
+
+bool types::eq(TypeId a, TypeId b) {
+    return a == b || a == UNKNOWN || b == UNKNOWN || below(a, b) || below(b, a);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+//
+// TYPES.hpp
+//
+// layouts the interned type table
+//
+
+#include "../lexer/token.hpp"
+#include "../snippets.h"
+
+#include <string_view>
+
+/**
+ * @namespace types holds every type name the parser came across once, so types can be compared as integers and
+ * everything that depends only on the name (operators, subtypes, LLVM IR type) is looked up instead of matched.
+ */
+namespace types {
+    typedef uint32 TypeId; //> index of an interned type (@see intern)
+
+    // the built-in types are interned first, so their ids are fixed
+    constexpr TypeId UNKNOWN   = 0;          //> "@unknown", a type not known yet. Equal to all others
+    constexpr TypeId NONE      = 1;          //> "", the result of operators that do not exist
+    constexpr TypeId ANY_INT   = 2;          //> "@int"
+    constexpr TypeId ANY_UINT  = 3;          //> "@uint"
+    constexpr TypeId ANY_FLOAT = 4;          //> "@float"
+    constexpr TypeId BOOL      = 5;          //> "bool"
+    constexpr TypeId CHAR      = 6;          //> "char"
+    constexpr TypeId NO_TYPE   = UINT32_MAX; //> no type at all, used for missing links
+
+    /**
+     * @struct Type everything known about an interned type
+     */
+    struct Type {
+            enum Class : uint8 {
+                OTHER,     //> any type without a fixed meaning (structs, arrays, ...)
+                SPECIAL,   //> @unknown and ""
+                BOOL,      //> bool
+                CHAR,      //> char
+                SINT,      //> int8 ... int128, ssize
+                UINT,      //> uint8 ... uint128, usize
+                FLOAT,     //> float16 ... float80
+                ANY_INT,   //> @int, any integer
+                ANY_UINT,  //> @uint, any unsigned integer
+                ANY_FLOAT, //> @float, any float
+            };
+
+            String name     = "";      //> the C* name
+            LLType ll       = "";      //> the LLVM IR type, as far as it can be told without a symbol table
+            bool   ll_fixed = false;   //> whether ll does not depend on the symbol table (@see parser::LLType)
+            Class  cls      = OTHER;   //> kind of type
+            uint16 bits     = 0;       //> size of numbers. 0 for usize and ssize, which depend on the target
+            TypeId super    = NO_TYPE; //> next bigger type in the subtype lattice (@see eq)
+            TypeId optional = NO_TYPE; //> for "T?" the TypeId of T
+
+            /**
+             * @brief whether this is an integer with a fixed size
+             */
+            inline bool isSizedInt() const { return (cls == SINT || cls == UINT) && bits != 0; }
+
+            inline bool isFloat() const { return cls == FLOAT; }
+    };
+
+    /**
+     * @brief get the TypeId of a type name, interning it on the first call. Thread-safe
+     */
+    TypeId intern(std::string_view name);
+
+    /**
+     * @brief get an interned type. Lock-free, ids stay valid for the whole compilation
+     */
+    const Type& get(TypeId id);
+
+    /**
+     * @brief get the type an operator on values of the types a and b yields. The operators of the built-in types
+     * are a precomputed table, so this takes constant time.
+     *
+     * @return the type, NONE if there is no such operator or UNKNOWN if either type is unknown
+     */
+    TypeId result(TypeId a, TypeId b, lexer::Token::Type op);
+
+    /**
+     * @brief check if values of a and b can be used for each other, i.e. one is a subtype of the other or either is
+     * unknown. @int holds all integers and @uint, @uint all unsigned integers and @float all floats
+     */
+    bool eq(TypeId a, TypeId b);
+} // namespace types
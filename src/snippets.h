@@ -127,8 +127,45 @@ class SegFException : public Exception {
         }
 };
 
-#define instanceOf(el, of) ((of*) el.get() == dynamic_cast<of*>(el.get()))
-#define cast2(a, to)       (std::dynamic_pointer_cast<to>(a))
+/**
+ * @brief declare the kind of a class' objects, for a class without subclasses. @see isa
+ */
+#define CLASS_KIND(k) static constexpr Kind KIND = k, FIRST_KIND = k, LAST_KIND = k;
+
+/**
+ * @brief declare the range of kinds a class and its subclasses have. @see isa
+ */
+#define CLASS_KINDS(first, last) static constexpr Kind FIRST_KIND = first, LAST_KIND = last;
+
+/**
+ * @brief check whether a is a T or one of T's subclasses. Objects carry a kind and each class declares the range
+ * of kinds it covers (@see CLASS_KIND), so this compares integers instead of doing a dynamic_cast
+ */
+template <typename T, typename From>
+inline bool isa(const From* a) {
+    return a != nullptr && T::FIRST_KIND <= a->kind && a->kind <= T::LAST_KIND;
+}
+
+template <typename T, typename From>
+inline bool isa(const sptr<From>& a) {
+    return isa<T>(a.get());
+}
+
+/**
+ * @brief cast a to T if it is one, else get nullptr. @see isa
+ */
+template <typename T, typename From>
+inline T* dyn_cast(From* a) {
+    return isa<T>(a) ? static_cast<T*>(a) : nullptr;
+}
+
+template <typename T, typename From>
+inline sptr<T> dyn_cast(const sptr<From>& a) {
+    return isa<T>(a) ? std::static_pointer_cast<T>(a) : nullptr;
+}
+
+#define instanceOf(el, of) ((el) == nullptr || isa<of>(el))
+#define cast2(a, to)       (dyn_cast<to>(a))
 
 /*template< typename T, typename T2 >
 inline std::pair<T,T2> operator , (T& t, T2& t2){
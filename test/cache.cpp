@@ -0,0 +1,199 @@
+//
+// CACHE.cpp
+//
+// tests for the on-disk token cache
+//
+
+#include "common.hpp"
+
+#include "../src/lexer/cache.hpp"
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const char* TEXT = "import std;\n"
+                          "/* a comment\n   over two lines */\n"
+                          "int32 main() {\n"
+                          "    float64 f = 1.5e3 + .5;\n"
+                          "    return 0x1F + 'c' + \"str\"; // done\n"
+                          "}\n";
+
+/**
+ * @class CacheDir points the cache to an empty directory of its own while it lives
+ */
+class CacheDir final {
+        String                          old_directory;
+        bool                            old_enabled;
+        std::vector<lexer::Diagnostic>* old_held;
+        std::vector<lexer::Diagnostic>  diagnostics = {};
+
+    public:
+        fs::path path;
+
+        CacheDir() {
+            path = fs::temp_directory_path() / ("cstc-cache-test-"s + std::to_string(::getpid()));
+            fs::remove_all(path);
+            old_directory           = lexer::cache::directory;
+            old_enabled             = lexer::cache::enabled;
+            old_held                = lexer::held;
+            lexer::cache::directory = path.string();
+            lexer::cache::enabled   = true;
+            lexer::held             = &diagnostics;
+        }
+
+        ~CacheDir() {
+            fs::remove_all(path);
+            lexer::cache::directory = old_directory;
+            lexer::cache::enabled   = old_enabled;
+            lexer::held             = old_held;
+        }
+
+        /**
+         * @brief get all cache entries
+         */
+        std::vector<fs::path> entries() const {
+            std::vector<fs::path> out = {};
+            if (!fs::exists(path)) { return out; }
+            for (const auto& e : fs::directory_iterator(path)) { out.push_back(e.path()); }
+            return out;
+        }
+};
+
+static String readFile(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return String((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const fs::path& path, const String& data) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(data.data(), data.size());
+}
+
+/**
+ * @brief tokenize text through the cache and check the tokens are the ones the lexer gives
+ */
+static void tokenizeChecked(const String& text) {
+    lexer::Source&     cached   = lexer::sources.add("cached.cst", text);
+    lexer::Source&     lexed    = lexer::sources.add("cached.cst", text);
+    lexer::TokenStream got      = lexer::cache::tokenize(cached);
+    lexer::TokenStream expected = lexer::tokenize(lexed);
+
+    // the Sources differ, so compare everything but the file
+    REQUIRE(got.size() == expected.size());
+    for (uint64 i = 0; i < expected.size(); i++) {
+        lexer::Token a = got[i], b = expected[i];
+        INFO("token " << i << ": \"" << a.value << "\" vs \"" << b.value << "\"");
+        REQUIRE(a.type == b.type);
+        REQUIRE(a.value == b.value);
+        REQUIRE(a.l == b.l);
+        REQUIRE(a.c == b.c);
+        REQUIRE(a.offset == b.offset);
+    }
+}
+
+/**
+ * @brief check that tokenizing TEXT hits entry. A hit does not write the entry again, so its time stays
+ */
+static void requireHit(const fs::path& entry) {
+    auto old = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    fs::last_write_time(entry, old);
+    tokenizeChecked(TEXT);
+    REQUIRE(fs::last_write_time(entry) == old);
+}
+
+/**
+ * @brief check that a damaged entry is not used: the text is lexed again and a valid entry is written instead
+ */
+static void requireRelexed(CacheDir& dir, const String& damaged) {
+    tokenizeChecked(TEXT);
+    REQUIRE(dir.entries().size() == 1);
+    fs::path entry = dir.entries()[0];
+
+    writeFile(entry, damaged);
+    tokenizeChecked(TEXT);
+    REQUIRE(readFile(entry) != damaged);
+    requireHit(entry);
+}
+
+TEST_CASE("the token cache is written on a miss and used on a hit", "[cache]") {
+    CacheDir dir;
+    tokenizeChecked(TEXT);
+    REQUIRE(dir.entries().size() == 1);
+    requireHit(dir.entries()[0]);
+    REQUIRE(dir.entries().size() == 1);
+}
+
+TEST_CASE("the token cache misses after the contents change", "[cache]") {
+    CacheDir dir;
+    tokenizeChecked(TEXT);
+    tokenizeChecked(TEXT + "int32 x = 1;\n"s);
+    REQUIRE(dir.entries().size() == 2);
+
+    String same_size = TEXT;
+    same_size[same_size.find("main")] = 'x';
+    tokenizeChecked(same_size);
+    REQUIRE(dir.entries().size() == 3);
+}
+
+TEST_CASE("the token cache misses after a same-length edit", "[cache]") {
+    CacheDir dir;
+    String   before = "int32 a = 1;\nint32 b = 2;\nint32 c = 3;\n";
+    String   after  = "int32 a!= 1;\nin932 b = 2;\nint32 c = 3;\n";
+    REQUIRE(lexer::cache::hash(before) != lexer::cache::hash(after));
+    tokenizeChecked(before);
+    tokenizeChecked(after);
+    REQUIRE(dir.entries().size() == 2);
+
+    SECTION("even if the hashes collide") {
+        // give the entry of before the name and hash of the entry of after, as a collision would
+        fs::path entry_before = dir.entries()[0], entry_after = dir.entries()[1];
+        if (readFile(entry_before).find(before) == String::npos) { std::swap(entry_before, entry_after); }
+        String forged    = readFile(entry_before);
+        uint64 text_hash = lexer::cache::hash(after);
+        std::memcpy(&forged[24], &text_hash, sizeof(text_hash)); // right after magic, version, pretty_size and size
+        uint64 data_hash = lexer::cache::hash(std::string_view(forged).substr(40));
+        std::memcpy(&forged[32], &data_hash, sizeof(data_hash));
+        writeFile(entry_after, forged);
+
+        tokenizeChecked(after);
+        REQUIRE(readFile(entry_after) != forged);
+    }
+}
+
+TEST_CASE("damaged token cache entries are not used", "[cache]") {
+    CacheDir dir;
+    tokenizeChecked(TEXT);
+    String good = readFile(dir.entries()[0]);
+    fs::remove_all(dir.path);
+
+    SECTION("truncated") { requireRelexed(dir, good.substr(0, good.size() / 2)); }
+    SECTION("cut inside the header") { requireRelexed(dir, good.substr(0, 12)); }
+    SECTION("empty") { requireRelexed(dir, ""); }
+    SECTION("trailing garbage") { requireRelexed(dir, good + "garbage"); }
+
+    SECTION("flipped bytes") {
+        for (uint64 at : {good.size() / 3, good.size() / 2, good.size() - 1}) {
+            String damaged = good;
+            damaged[at]    ^= 0x5a;
+            requireRelexed(dir, damaged);
+        }
+    }
+
+    SECTION("other version") {
+        String damaged = good;
+        uint32 version = lexer::cache::VERSION + 1;
+        std::memcpy(&damaged[8], &version, sizeof(version)); // right after the magic
+        requireRelexed(dir, damaged);
+    }
+
+    SECTION("only the magic") { requireRelexed(dir, "CSTCTOK"); }
+}
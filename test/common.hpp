@@ -0,0 +1,29 @@
+#pragma once
+
+//
+// COMMON.hpp
+//
+// helpers shared by the tests
+//
+
+// catch2 goes first, snippets.h defines macros (like Exception) that clash with it
+#include <catch2/catch.hpp>
+
+#include "../src/lexer/token.hpp"
+
+/**
+ * @brief check that two token streams hold the same tokens at the same places
+ */
+inline void requireSameTokens(const lexer::TokenStream& got, const lexer::TokenStream& expected) {
+    REQUIRE(got.size() == expected.size());
+    for (uint64 i = 0; i < expected.size(); i++) {
+        lexer::Token a = got[i], b = expected[i];
+        INFO("token " << i << ": \"" << a.value << "\" vs \"" << b.value << "\"");
+        REQUIRE(a.type == b.type);
+        REQUIRE(a.value == b.value);
+        REQUIRE(a.l == b.l);
+        REQUIRE(a.c == b.c);
+        REQUIRE(a.offset == b.offset);
+        REQUIRE(a.file == b.file);
+    }
+}
@@ -0,0 +1,243 @@
+//
+// FOLD.cpp
+//
+// tests for constant folding: the engine on its own and the operators that use it
+//
+
+#include "common.hpp"
+
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/ast/base_math.hpp"
+#include "../src/parser/errors.hpp"
+#include "../src/parser/fold.hpp"
+#include "../src/parser/symboltable.hpp"
+#include "../src/parser/types.hpp"
+
+using Op = lexer::Token::Type;
+
+/**
+ * @struct Case a row of the engine tables: a op b in type gives result. A result of nullptr means the operator can
+ * not be folded
+ */
+struct Case {
+        Op          op;
+        const char* type;
+        const char* a;
+        const char* b;
+        const char* result;
+        bool        overflow = false;
+};
+
+static void requireFolds(const Case& c) {
+    types::TypeId  type = types::intern(c.type);
+    fold::Constant r    = fold::binary(c.op, fold::read(type, c.a), fold::read(type, c.b));
+    INFO(c.type << ": " << c.a << " " << lexer::getTokenName(c.op) << " " << c.b);
+    if (c.result == nullptr) {
+        REQUIRE_FALSE(r.valid());
+        return;
+    }
+    REQUIRE(r.valid());
+    REQUIRE(fold::write(r) == c.result);
+    REQUIRE(r.overflow == c.overflow);
+}
+
+// clang-format off
+static const Case SIGNED[] = {
+    {Op::ADD,     "int8",  "100",  "27",  "127"},
+    {Op::ADD,     "int8",  "100",  "28",  "-128", true},
+    {Op::SUB,     "int8",  "-100", "28",  "-128"},
+    {Op::SUB,     "int8",  "-100", "29",  "127",  true},
+    {Op::MUL,     "int32", "-3",   "7",   "-21"},
+    {Op::MUL,     "int8",  "16",   "8",   "-128", true},
+    {Op::MUL,     "int64", "4294967296", "4294967296", "0", true},
+    {Op::DIV,     "int32", "7",    "-2",  "-3"},
+    {Op::DIV,     "int8",  "-128", "-1",  "-128", true},
+    {Op::DIV,     "int32", "1",    "0",   nullptr},
+    {Op::MOD,     "int32", "-7",   "2",   "-1"},
+    {Op::MOD,     "int32", "5",    "0",   nullptr},
+    {Op::POW,     "int8",  "2",    "6",   "64"},
+    {Op::POW,     "int8",  "2",    "7",   "-128", true},
+    {Op::POW,     "int32", "-1",   "-3",  "-1"},
+    {Op::POW,     "int32", "2",    "-1",  "0"},
+    {Op::POW,     "int32", "0",    "-1",  nullptr},
+    {Op::AND,     "int8",  "-1",   "15",  "15"},
+    {Op::OR,      "int8",  "12",   "3",   "15"},
+    {Op::XOR,     "int8",  "-1",   "1",   "-2"},
+    {Op::EQ,      "int16", "-1",   "-1",  "true"},
+    {Op::NEQ,     "int16", "-1",   "-1",  "false"},
+    {Op::LESS,    "int8",  "-1",   "1",   "true"},
+    {Op::GREATER, "int8",  "-1",   "1",   "false"},
+    {Op::LEQ,     "int64", "5",    "5",   "true"},
+    {Op::GEQ,     "int64", "-5",   "5",   "false"},
+    {Op::LAND,    "int32", "1",    "1",   nullptr},
+};
+
+static const Case UNSIGNED[] = {
+    {Op::ADD,     "uint8",  "255", "1",   "0",   true},
+    {Op::ADD,     "uint64", "18446744073709551615", "1", "0", true},
+    {Op::SUB,     "uint8",  "0",   "1",   "255", true},
+    {Op::SUB,     "uint8",  "7",   "2",   "5"},
+    {Op::MUL,     "uint16", "256", "255", "65280"},
+    {Op::MUL,     "uint16", "256", "256", "0",   true},
+    {Op::MUL,     "uint64", "4294967296", "4294967296", "0", true},
+    {Op::DIV,     "uint8",  "200", "3",   "66"},
+    {Op::DIV,     "uint8",  "1",   "0",   nullptr},
+    {Op::MOD,     "uint8",  "200", "7",   "4"},
+    {Op::MOD,     "uint8",  "200", "0",   nullptr},
+    {Op::POW,     "uint8",  "3",   "5",   "243"},
+    {Op::POW,     "uint8",  "2",   "8",   "0",   true},
+    {Op::AND,     "uint8",  "0xF0", "0x3C", "48"},
+    {Op::OR,      "uint8",  "0xF0", "0x0F", "255"},
+    {Op::XOR,     "uint8",  "0xFF", "0x0F", "240"},
+    {Op::GREATER, "uint8",  "255", "1",   "true"}, // the same bits are -1 > 1 as an int8
+    {Op::LESS,    "uint32", "0",   "1",   "true"},
+    {Op::EQ,      "uint8",  "256", "0",   "true"}, // 256 is read as 0
+    {Op::LOR,     "uint8",  "1",   "0",   nullptr},
+};
+
+static const Case FLOATS[] = {
+    {Op::ADD,     "float32", "16777216", "1",   "16777216"}, // float32 has 24 bits of mantissa
+    {Op::ADD,     "float64", "16777216", "1",   "16777217"},
+    {Op::ADD,     "float64", "0.1",      "0.2", "0.30000000000000004"},
+    {Op::SUB,     "float64", "1",        "0.5", "0.5"},
+    {Op::MUL,     "float32", "1.5",      "2",   "3"},
+    {Op::DIV,     "float64", "1",        "0",   "inf"},
+    {Op::DIV,     "float64", "-1",       "0",   "-inf"},
+    {Op::MOD,     "float64", "7.5",      "2",   "1.5"},
+    {Op::POW,     "float64", "2",        "0.5", "1.4142135623730951"},
+    {Op::EQ,      "float32", "0.1",      "0.1", "true"},
+    {Op::LESS,    "float64", "0.1",      "0.2", "true"},
+    {Op::GEQ,     "float80", "2",        "3",   "false"},
+    {Op::AND,     "float64", "1",        "1",   nullptr},
+    {Op::XOR,     "float32", "1",        "1",   nullptr},
+};
+
+static const Case BOOLS[] = {
+    {Op::LAND,    "bool", "true",  "false", "false"},
+    {Op::LOR,     "bool", "true",  "false", "true"},
+    {Op::AND,     "bool", "true",  "true",  "true"},
+    {Op::OR,      "bool", "false", "false", "false"},
+    {Op::XOR,     "bool", "true",  "true",  "false"},
+    {Op::EQ,      "bool", "false", "false", "true"},
+    {Op::NEQ,     "bool", "true",  "false", "true"},
+    {Op::ADD,     "bool", "true",  "true",  nullptr},
+    {Op::LESS,    "bool", "false", "true",  nullptr},
+};
+// clang-format on
+
+TEST_CASE("signed ints fold and wrap around like their type", "[fold]") {
+    for (const Case& c : SIGNED) { requireFolds(c); }
+}
+
+TEST_CASE("unsigned ints fold and wrap around like their type", "[fold]") {
+    for (const Case& c : UNSIGNED) { requireFolds(c); }
+}
+
+TEST_CASE("floats fold in the precision of their type", "[fold]") {
+    for (const Case& c : FLOATS) { requireFolds(c); }
+}
+
+TEST_CASE("bools fold", "[fold]") {
+    for (const Case& c : BOOLS) { requireFolds(c); }
+}
+
+TEST_CASE("unary operators and invalid operands do not fold", "[fold]") {
+    types::TypeId int8 = types::intern("int8"), uint8 = types::intern("uint8"), bool_t = types::intern("bool");
+
+    REQUIRE(fold::write(fold::unary(Op::NEG, fold::read(int8, "0"))) == "-1");
+    REQUIRE(fold::write(fold::unary(Op::NEG, fold::read(uint8, "0"))) == "255");
+    REQUIRE_FALSE(fold::unary(Op::NEG, fold::read(uint8, "0")).overflow);
+    REQUIRE(fold::write(fold::unary(Op::NOT, fold::read(bool_t, "true"))) == "false");
+    REQUIRE_FALSE(fold::unary(Op::NOT, fold::read(int8, "1")).valid());
+
+    REQUIRE_FALSE(fold::read(int8, "abc").valid());
+    REQUIRE_FALSE(fold::read(int8, "").valid());
+    REQUIRE_FALSE(fold::read(bool_t, "1").valid());
+    REQUIRE(fold::write(fold::read(int8, "0x7F")) == "127");
+    REQUIRE_FALSE(fold::binary(Op::ADD, fold::read(int8, "1"), fold::read(uint8, "1")).valid());
+}
+
+/**
+ * @class Folded parses an expression, forces it to a type and keeps the diagnostics it made
+ */
+class Folded final {
+        std::vector<lexer::Diagnostic> lexed = {};
+        parser::Held                   before;
+        symbol::Namespace              sr    = symbol::Namespace("fold");
+
+    public:
+        sptr<AST> ast;
+        String    diagnostics = "";
+        uint64    errors      = 0;
+
+        Folded(const String& text, const String& type) {
+            lexer::held = &lexed;
+            parser::holding++;
+            before = parser::held();
+
+            // the lexer needs something after the last token
+            ast = math::parse(lexer::tokenize(lexer::sources.add("fold.cst", text + "\n")), 0, &sr, type);
+            if (ast != nullptr) { ast->forceType(type); }
+
+            errors = parser::releaseHeld(before, diagnostics).errc;
+            parser::holding--;
+            lexer::held = nullptr;
+        }
+};
+
+TEST_CASE("every folded operator builds its own node", "[fold]") {
+    struct Row {
+            const char* text;
+            const char* type;
+            AST::Kind   kind;
+            const char* value;
+    };
+
+    // clang-format off
+    for (Row r : std::initializer_list<Row>{
+             {"7 + 3",        "int32",   AST::ADD,  "10"},   {"7 - 3",        "int32",   AST::SUB,  "4"},
+             {"7 * 3",        "int32",   AST::MUL,  "21"},   {"7 / 3",        "int32",   AST::DIV,  "2"},
+             {"7 % 3",        "int32",   AST::MOD,  "1"},    {"2 ** 10",      "int32",   AST::POW,  "1024"},
+             {"6 & 3",        "int32",   AST::AND,  "2"},    {"6 | 3",        "int32",   AST::OR,   "7"},
+             {"6 ^ 3",        "int32",   AST::XOR,  "5"},    {"true && false", "bool",   AST::LAND, "false"},
+             {"true || false", "bool",   AST::LOR,  "true"}, {"1 == 2",       "bool",    AST::EQ,   "false"},
+             {"1 != 2",       "bool",    AST::NEQ,  "true"}, {"1 < 2",        "bool",    AST::LT,   "true"},
+             {"1 > 2",        "bool",    AST::GT,   "false"}, {"2 <= 2",      "bool",    AST::LEQ,  "true"},
+             {"1 >= 2",       "bool",    AST::GEQ,  "false"}, {"!true",       "bool",    AST::NOT,  "false"},
+             {"~0",           "uint16",  AST::NEG,  "65535"}, {"1.5 * 2.0",   "float64", AST::MUL,  "3"},
+             {"2 * 3 % 4",    "int32",   AST::MOD,  "2"},    {"1 != 2 == true", "bool",   AST::EQ,   "true"},
+         }) {
+        // clang-format on
+        INFO(r.text << " as " << r.type);
+        Folded f(r.text, r.type);
+        REQUIRE(f.errors == 0);
+        REQUIRE(f.ast != nullptr);
+        REQUIRE(f.ast->kind == r.kind);
+        REQUIRE(f.ast->is_const);
+        REQUIRE(f.ast->value == r.value);
+    }
+}
+
+TEST_CASE("nowrap reports overflows of nested operators", "[fold]") {
+    for (const char* text : {"nowrap(200 * 2 / 2)", "nowrap((200 + 100) - 100)", "nowrap(~(255 + 1))"}) {
+        INFO(text);
+        Folded f(text, "uint8");
+        REQUIRE(f.errors == 1);
+        REQUIRE(f.diagnostics.find("Integer overflow") != String::npos);
+    }
+
+    Folded nested("nowrap((2147483647 + 1) / 2)", "int32");
+    REQUIRE(nested.errors == 1);
+    REQUIRE(nested.diagnostics.find("Integer overflow") != String::npos);
+
+    // reported by the inner nowrap only
+    Folded twice("nowrap(nowrap(100 + 100) + 1)", "int8");
+    REQUIRE(twice.errors == 1);
+
+    for (const char* text : {"nowrap(200 / 2 * 2)", "nowrap(100 + 100 - 100)", "100 + 100"}) {
+        INFO(text);
+        Folded f(text, "uint8");
+        REQUIRE(f.errors == 0);
+    }
+}
@@ -0,0 +1,104 @@
+//
+// LEXER.cpp
+//
+// tests for the lexer
+//
+
+#include "common.hpp"
+
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/lexer/token.hpp"
+
+#include <random>
+#include <vector>
+
+// pieces random texts and edits are made of. They open and close comments and strings on purpose
+static const char* PIECES[] = {
+    "", "a", "x1", " ", "\t", "\n", "\n\n", "\r\n", "(", ")", "{", "}", ";", "...", "..", "==", "+=", "->", "::",
+    "//", "/*", "*/", "\"", "'", "/* c */", "// line\n", "/* /* */ */", "\"str\\\"ing\"", "'c'", "0x1F", "1.5e3",
+    "int32 x = 5;\n", "if (a) {\n b();\n}\n", "<<<<<<< HEAD\n", "=======\n", ">>>>>>> x\n",
+};
+
+static const char* randomPiece(std::mt19937_64& rng) {
+    return PIECES[rng() % (sizeof(PIECES) / sizeof(PIECES[0]))];
+}
+
+TEST_CASE("retokenize gives the same tokens as lexing the whole file again", "[lexer]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held        = &diagnostics; // random texts are full of errors, keep them out of the test output
+    lexer::pretty_size = 100;
+
+    std::mt19937_64 rng(1234);
+    for (int file = 0; file < 20; file++) {
+        String text = "";
+        for (int i = 0; i < 60; i++) { text += randomPiece(rng); }
+
+        lexer::Source*     source = &lexer::sources.add("retokenize.cst", text);
+        lexer::TokenStream tokens = lexer::tokenize(*source);
+        for (int edit = 0; edit < 50; edit++) {
+            lexer::Edit e;
+            uint64      size = source->text.size();
+            e.offset         = rng() % (size + 1);
+            e.length         = rng() % 4 == 0 ? 0 : std::min<uint64>(rng() % 12, size - e.offset);
+            e.replacement    = randomPiece(rng);
+            INFO("file " << file << ", edit " << edit << ": " << e.length << " bytes at " << e.offset << " replaced by \""
+                         << e.replacement << "\"");
+
+            lexer::Source&     next = lexer::sources.add("retokenize.cst", e.apply(source->text));
+            lexer::TokenStream inc  = lexer::retokenize(tokens, *source, next, e);
+            lexer::TokenStream full = lexer::tokenize(next);
+            requireSameTokens(inc, full);
+
+            source = &next;
+            tokens = full;
+        }
+    }
+    lexer::held = nullptr;
+}
+
+TEST_CASE("retokenize handles edits at the start and the end of a file", "[lexer]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+
+    String             text   = "int32 a = 1;\n/* comment\n*/ int32 b = a;\n";
+    lexer::Source&     source = lexer::sources.add("edges.cst", text);
+    lexer::TokenStream tokens = lexer::tokenize(source);
+
+    for (lexer::Edit e : {lexer::Edit{0, 0, "// "}, lexer::Edit{text.size(), 0, "/*"}, lexer::Edit{0, text.size(), "x"},
+                          lexer::Edit{13, 2, ""}}) {
+        lexer::Source& next = lexer::sources.add("edges.cst", e.apply(source.text));
+        requireSameTokens(lexer::retokenize(tokens, source, next, e), lexer::tokenize(next));
+    }
+    lexer::held = nullptr;
+}
+
+TEST_CASE("lexing on threads keeps the diagnostics held back by the caller", "[lexer]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+    int32  pretty_size = lexer::pretty_size;
+    uint32 threads     = lexer::threads;
+    uint64 min         = lexer::parallel_min;
+
+    // every line is too long, so each chunk has warnings
+    String text = "";
+    for (uint64 i = 0; i < 64; i++) { text += "int32 a_rather_long_name_" + std::to_string(i) + " = 1 + 2 + 3 + 4 + 5;\n"; }
+    lexer::pretty_size = 40;
+    lexer::threads     = 1;
+    lexer::tokenize(lexer::sources.add("threads.cst", text));
+    uint64 serial = diagnostics.size();
+    diagnostics.clear();
+
+    lexer::threads      = 4;
+    lexer::parallel_min = 0;
+    lexer::tokenize(lexer::sources.add("threads.cst", text));
+
+    REQUIRE(lexer::held == &diagnostics);
+    REQUIRE(serial >= 64);
+    REQUIRE(diagnostics.size() == serial);
+
+    lexer::pretty_size  = pretty_size;
+    lexer::threads      = threads;
+    lexer::parallel_min = min;
+    lexer::held         = nullptr;
+}
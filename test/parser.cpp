@@ -0,0 +1,175 @@
+//
+// PARSER.cpp
+//
+// tests for the parser and its nodes
+//
+
+#include "common.hpp"
+
+#include "../src/lexer/errors.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/arena.hpp"
+#include "../src/parser/ast/base_math.hpp"
+#include "../src/parser/ast/func.hpp"
+#include "../src/parser/ast/literal.hpp"
+#include "../src/parser/ast/type.hpp"
+#include "../src/parser/errors.hpp"
+#include "../src/parser/parser.hpp"
+#include "../src/parser/symboltable.hpp"
+
+static lexer::TokenStream tokensOf(const String& text) {
+    return lexer::tokenize(lexer::sources.add("parser.cst", text));
+}
+
+/**
+ * @brief open a checkpoint, report an error, add a symbol and consume a variable in it, then roll it back
+ */
+static void speculate(symbol::Namespace& sr, symbol::Variable* n, const lexer::TokenStream& tokens) {
+    parser::Checkpoint checkpoint;
+    parser::error("Speculative error", tokens, "this error is only made while speculating", 0);
+    sr.add("y", new symbol::Variable("y", "int32", tokens, &sr));
+    n->setStatus(symbol::Variable::CONSUMED, tokens);
+    {
+        parser::Checkpoint inner; // committed into the outer one, which still rolls it back
+        parser::warn("Speculative warning", tokens, "this warning is only made while speculating", 0);
+        sr.add("z", new symbol::Variable("z", "int32", tokens, &sr));
+    }
+    checkpoint.rollback();
+}
+
+TEST_CASE("a rolled back checkpoint leaves no diagnostics or symbols behind", "[parser]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+
+    lexer::TokenStream tokens = tokensOf("int32 n = 1;");
+    symbol::Namespace  sr("test");
+    symbol::Variable*  n = new symbol::Variable("n", "int32", tokens, &sr);
+    sr.add("n", n);
+    n->setStatus(symbol::Variable::PROVIDED, tokens);
+
+    uint64 errc = parser::errc, warnc = parser::warnc;
+
+    SECTION("nothing held") { speculate(sr, n, tokens); }
+
+    SECTION("under a module hold") {
+        parser::holding++;
+        speculate(sr, n, tokens);
+        REQUIRE(parser::held().size == 0);
+        REQUIRE(parser::held().errc == 0);
+        REQUIRE(parser::held().warnc == 0);
+        parser::holding--;
+    }
+
+    REQUIRE(parser::errc == errc);
+    REQUIRE(parser::warnc == warnc);
+    REQUIRE(sr.getLocal("y").empty());
+    REQUIRE(sr.getLocal("z").empty());
+    REQUIRE(n->used == symbol::Variable::PROVIDED);
+    REQUIRE(symbol::journal::size() == 0);
+    lexer::held = nullptr;
+}
+
+TEST_CASE("a committed checkpoint under a module hold leaves its diagnostics held", "[parser]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+
+    lexer::TokenStream tokens = tokensOf("int32 n = 1;");
+    symbol::Namespace  sr("test");
+
+    parser::holding++;
+    {
+        parser::Checkpoint checkpoint;
+        parser::error("Held error", tokens, "this error belongs to the module", 0);
+        sr.add("y", new symbol::Variable("y", "int32", tokens, &sr));
+    }
+    REQUIRE(parser::held().errc == 1);
+    REQUIRE(symbol::journal::size() == 0); // the changes can not be undone anymore
+    REQUIRE(sr.getLocal("y").size() == 1);
+
+    // what a module does with its diagnostics
+    String       text;
+    parser::Held amount = parser::releaseHeld({}, text);
+    parser::holding--;
+    REQUIRE(amount.errc == 1);
+    REQUIRE(text.find("Held error") != String::npos);
+    lexer::held = nullptr;
+}
+
+TEST_CASE("len() on something that is no array does not consume it", "[parser]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+
+    lexer::TokenStream decl = tokensOf("int32 n = 1;");
+    symbol::Namespace  sr("test");
+    symbol::Variable*  n = new symbol::Variable("n", "int32", decl, &sr);
+    sr.add("n", n);
+    n->setStatus(symbol::Variable::PROVIDED, decl);
+
+    uint64 errc = parser::errc;
+    REQUIRE(ArrayLengthAST::parse(tokensOf("n.len()"), 0, &sr, "usize") == nullptr);
+    REQUIRE(n->used == symbol::Variable::PROVIDED);
+    REQUIRE(parser::errc == errc);
+    REQUIRE(parser::held().size == 0);
+    lexer::held = nullptr;
+}
+
+TEST_CASE("nodes know their kind however they are created", "[parser]") {
+    lexer::TokenStream tokens = tokensOf("1 + 2");
+    sptr<AST>          one    = std::make_shared<NullLiteralAST>(tokens);
+    sptr<AST>          two    = parser::make<NullLiteralAST>(tokens);
+    sptr<AST>          add    = std::make_shared<AddAST>(one, two, tokens);
+
+    REQUIRE(one->kind == AST::NULL_LITERAL);
+    REQUIRE(two->kind == AST::NULL_LITERAL);
+    REQUIRE(add->kind == AST::ADD);
+    REQUIRE(isa<DoubleOperandAST>(add));
+    REQUIRE(std::make_shared<TypeAST>()->kind == AST::TYPE);
+    REQUIRE(std::make_shared<ArrayTypeAST>(std::make_shared<TypeAST>("int32"))->kind == AST::ARRAY_TYPE);
+}
+
+/**
+ * @brief declare a function whose body is only parsed when it is first used, as for imported modules
+ */
+static symbol::Function* declareLazily(symbol::Namespace& sr, const String& name, const String& text) {
+    std::vector<FuncDefAST::Deferred> later = {};
+    FuncDefAST::deferred                    = &later;
+    sptr<AST> def                           = FuncDefAST::parse(tokensOf(text), 0, &sr);
+    FuncDefAST::deferred                    = nullptr;
+    REQUIRE(later.size() == 1);
+    FuncDefAST::parseLater(later[0].def);
+    return (symbol::Function*) sr.getLocal(name).at(0);
+}
+
+TEST_CASE("a lazily parsed body is kept when the checkpoint around its first use rolls back", "[parser]") {
+    std::vector<lexer::Diagnostic> diagnostics;
+    lexer::held = &diagnostics;
+
+    symbol::Namespace sr("test");
+    symbol::Function* fn   = declareLazily(sr, "get", "int32 get() {\n    int32 local = 1;\n}\n");
+    uint64            errc = parser::errc;
+
+    SECTION("nothing held") {
+        REQUIRE(ArrayLengthAST::parse(tokensOf("get().len()\n"), 0, &sr, "usize") == nullptr);
+        REQUIRE(parser::errc > errc); // the body does not return
+    }
+
+    SECTION("under a module hold") {
+        parser::holding++;
+        {
+            parser::Checkpoint outer;
+            parser::warn("Speculative warning", tokensOf("int32 n;"), "made before the body was parsed", 0);
+            REQUIRE(ArrayLengthAST::parse(tokensOf("get().len()\n"), 0, &sr, "usize") == nullptr);
+            outer.rollback();
+        }
+        REQUIRE(parser::held().errc > 0);
+        String text = parser::takeHeld();
+        REQUIRE(text.find("Unreturned function") != String::npos);
+        REQUIRE(text.find("Speculative warning") == String::npos);
+        parser::holding--;
+    }
+
+    REQUIRE(fn->definition == nullptr);
+    REQUIRE(fn->getLocal("local").size() == 1);
+    REQUIRE(symbol::journal::size() == 0);
+    lexer::held = nullptr;
+}